@@ -26,6 +26,7 @@
 
 #include "tm4c123gh6pm.h"
 #include "ADC0SS2.h"
+#include "Trace.h"
 #include <stdint.h>
 
 // There are many choices to make when using the ADC, and many
@@ -93,8 +94,10 @@ void ADC0_SS2_Init213(void){
 // Ain1 (PE2) 0 to 4095
 // Ain3 (PE0) 0 to 4095
 void ADC0_SS2_In213(uint16_t *ain2, uint16_t *ain1, uint16_t *ain3){
+  TRACE_STAMP(TRACE_ADC_START);
   ADC0_PSSI_R = 0x0004;            // 1) initiate SS2
   while((ADC0_RIS_R&0x04)==0){};   // 2) wait for conversion done:3210->0100->4
+  TRACE_STAMP(TRACE_ADC_DONE);
   *ain2 = ADC0_SSFIFO2_R&0xFFF;    // 3A) read first result
   *ain1 = ADC0_SSFIFO2_R&0xFFF;    // 3B) read second result
   *ain3 = ADC0_SSFIFO2_R&0xFFF;    // 3C) read third result
@@ -182,4 +185,5 @@ void ReadADCMedianFilter(uint16_t *ain2, uint16_t *ain1, uint16_t *ain3){
   *ain3 = median(ain3newest, ain3middle, ain3oldest);
   ain2oldest = ain2middle; ain1oldest = ain1middle; ain3oldest = ain3middle;
   ain2middle = ain2newest; ain1middle = ain1newest; ain3middle = ain3newest;
+  TRACE_STAMP(TRACE_FILTER);
 }
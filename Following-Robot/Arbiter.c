@@ -0,0 +1,69 @@
+// Arbiter.c
+// Runs on TM4C123, and on a host PC for testing
+// Subsumption arbiter, see Arbiter.h.
+
+#include <stdint.h>
+#include "Arbiter.h"
+
+static const Layer *Table;
+static uint8_t Count;
+static uint32_t (*Cycles)(void);
+static uint8_t Driver;              // layer that won the last round
+static LayerStats Stats[ARB_MAX_LAYERS];
+
+void Arbiter_Init(const Layer *table, uint8_t count, uint32_t (*cycles)(void)){
+  uint8_t i;
+  if (count > ARB_MAX_LAYERS){
+    count = ARB_MAX_LAYERS;
+  }
+  Table = table;
+  Count = count;
+  Cycles = cycles;
+  for(i=0; i<count; i++){
+    Stats[i].runs = Stats[i].wins = Stats[i].suppressed = 0;
+    Stats[i].overruns = Stats[i].wcet = 0;
+  }
+  Driver = ARB_NONE;
+}
+
+void Arbiter_Reset(void){
+  Driver = ARB_NONE;
+}
+
+uint8_t Arbiter_Step(const SensorFrame *ir, uint32_t enable, MotionCmd *cmd){
+  uint8_t i, winner = ARB_NONE;
+  uint32_t start, elapsed;
+  cmd->kind = CMD_NONE;
+  for(i=0; i<Count; i++){
+    if ((enable&(1u<<i)) == 0){
+      continue;
+    }
+    if (winner != ARB_NONE){
+      Stats[i].suppressed++;
+      continue;
+    }
+    start = Cycles();
+    Table[i].propose(ir, cmd);
+    elapsed = Cycles() - start;
+    Stats[i].runs++;
+    if (elapsed > Stats[i].wcet){
+      Stats[i].wcet = elapsed;
+    }
+    if (elapsed > Table[i].budget){
+      Stats[i].overruns++;
+    }
+    if (cmd->kind != CMD_NONE){
+      winner = i;
+      Stats[i].wins++;
+    }
+  }
+  if ((winner != Driver)&&(Driver != ARB_NONE)&&Table[Driver].release){
+    Table[Driver].release();
+  }
+  Driver = winner;
+  return winner;
+}
+
+const LayerStats *Arbiter_Stats(uint8_t i){
+  return &Stats[i];
+}
@@ -0,0 +1,71 @@
+// Arbiter.h
+// Runs on TM4C123, and on a host PC for testing
+// Subsumption arbiter for the motion behaviours, with a compile-time
+// layer table sorted by priority, highest first. Every control tick
+// Arbiter_Step() asks the enabled layers in order for a motion
+// command. The first one that proposes anything but CMD_NONE wins; the
+// layers below it are suppressed and not run at all, so a tick costs
+// only the layers down to the winner.
+// Each layer has a cycle budget. The arbiter cannot preempt a layer,
+// so a layer that takes longer is counted as an overrun in its
+// statistics rather than cut short.
+// A layer that loses control of the motors to another one gets its
+// release hook called, e.g. to clear a controller's integrator.
+// The module touches no hardware: the caller carries out the winning
+// command, and the time source is passed to Arbiter_Init().
+
+#ifndef ARBITER_H
+#define ARBITER_H
+#include <stdint.h>
+#include "Sensors.h"
+
+#define ARB_MAX_LAYERS 8
+#define ARB_NONE 0xFF               // Arbiter_Step(): no layer proposed anything
+
+// Command kinds
+#define CMD_NONE    0               // no opinion, ask the next layer
+#define CMD_HOLD    1               // a manoeuvre is running, leave the motors alone
+#define CMD_BRAKE   2
+#define CMD_WHEELS  3               // signed duties left, right, see Set_Wheels()
+#define CMD_BACKOFF 4               // brake, then reverse at left, right for arg ms
+#define CMD_PIVOT   5               // pivot by arg degrees at duty left, see Motion_Pivot()
+#define CMD_STEER   6               // SteerLut command bits in arg, side 1 for a left wall
+
+typedef struct {
+  uint8_t kind;
+  uint8_t side;
+  int16_t left, right;
+  int16_t arg;
+} MotionCmd;
+
+typedef struct {
+  void (*propose)(const SensorFrame *ir, MotionCmd *cmd); // cmd->kind is CMD_NONE on entry
+  void (*release)(void);    // 0: nothing to do
+  uint32_t budget;          // in time source units
+} Layer;
+
+typedef struct {
+  uint32_t runs;            // times propose was called
+  uint32_t wins;            // ticks this layer's command was carried out
+  uint32_t suppressed;      // ticks skipped because a higher layer won
+  uint32_t overruns;        // runs longer than the budget
+  uint32_t wcet;            // worst time of one run
+} LayerStats;
+
+// Start the arbiter with a layer table of count entries
+// cycles returns a free-running time stamp, used for budgets and statistics
+void Arbiter_Init(const Layer *table, uint8_t count, uint32_t (*cycles)(void));
+
+// Forget which layer drives the motors, without calling its release
+// hook. Call when the motors were stopped by something else.
+void Arbiter_Reset(void);
+
+// One arbitration round over the layers whose bit is set in enable
+// Output: index of the winning layer, its command in *cmd, or
+// ARB_NONE with cmd->kind CMD_NONE
+uint8_t Arbiter_Step(const SensorFrame *ir, uint32_t enable, MotionCmd *cmd);
+
+// Statistics for layer i, in table order
+const LayerStats *Arbiter_Stats(uint8_t i);
+
+#endif
@@ -0,0 +1,538 @@
+// Behavior.c
+// Runs on TM4C123
+// Behaviour state machine, see Behavior.h.
+
+#include <stdint.h>
+#include "Behavior.h"
+#include "ADC0SS2.h"
+#include "Motors.h"
+#include "Motion.h"
+#include "Trajectory.h"
+#include "Stall.h"
+#include "EStop.h"
+#include "Power.h"
+#include "Buttons.h"
+#include "Follow.h"
+#include "Wall.h"
+#include "SteerLut.h"
+#include "Steer.h"
+#include "Hyst.h"
+#include "Arbiter.h"
+#include "ModeSelect.h"
+#include "Search.h"
+#include "SysTickInts.h"
+#include "Trace.h"
+#include "CycleCount.h"
+
+#define CORNER_DEG 90 // wall follower turn when a wall is ahead
+#define STALL_BACKOFF_MS 300 // reverse after a wheel stall
+
+// With the bang-bang controllers, STEER_LUT=1 looks their decisions up
+// in SteerLut[] instead of running the branches
+#ifndef STEER_LUT
+#define STEER_LUT 1
+#endif
+
+// STEER_HYST=1 passes the readings the steering compares against
+// FOLLOW_DIST and WALL_DIST through comparators with a +/- band and a
+// minimum dwell, so noise around a threshold cannot toggle the wheels
+// every control tick. The bands are in Behavior.h.
+#ifndef STEER_HYST
+#define STEER_HYST 1
+#endif
+
+// Layer budgets in bus cycles: a few compares, a control law
+#define CHECK_BUDGET   400
+#define CONTROL_BUDGET 4000
+
+// AUTO_MODE=1 lets the mode selector switch between the follower
+// modes while running, without a button press. Off until the
+// ModeSelect.h thresholds have been tuned on the robot.
+#ifndef AUTO_MODE
+#define AUTO_MODE 0
+#endif
+
+#define EV_NONE 0xFF
+
+typedef struct {
+  void (*entry)(void);
+  void (*exit)(void);
+  uint8_t (*run)(const SensorFrame *ir); // returns an event or EV_NONE
+  uint8_t resumable;                     // 1: remembered for ST_HISTORY
+} StateDef;
+
+typedef struct {
+  uint8_t next;                 // ST_NONE: ignore the event
+  uint8_t alt;                  // taken instead when the guard fails
+  uint8_t (*guard)(void);       // 0: always pass
+} Transition;
+
+static volatile uint8_t State;
+static uint8_t History;         // last resumable state
+static const SensorFrame *Frame; // frame of the current step, for guards
+static uint8_t Pushed;          // ST_BACKOFF: back-off segment queued
+static uint8_t SideBraked;      // Avoid layer: braked for the current side intrusion
+uint32_t Behavior_DispatchCycles;
+
+static const HystBand FollowBand = {FOLLOW_DIST+FOLLOW_HYST, FOLLOW_DIST-FOLLOW_HYST, MS_TO_TICKS(STEER_DWELL_MS)};
+static const HystBand WallBand = {WALL_DIST+WALL_HYST, WALL_DIST-WALL_HYST, MS_TO_TICKS(STEER_DWELL_MS)};
+static const HystBand FrontBand = {WALL_DIST+1+WALL_HYST, WALL_DIST+1-WALL_HYST, MS_TO_TICKS(STEER_DWELL_MS)}; // ahead > WALL_DIST
+static Hyst HAhead, HLeft, HRight; // bound to the bands of the current state
+
+static void Halt_Motion(void){
+  if (Motion_Status() == MOTION_BUSY){
+    Motion_Cancel();
+  }
+  if (Trajectory_Busy()){
+    Trajectory_Clear();
+  }
+}
+
+// Carry out a SteerLut command, see SteerLut.h
+static void Steer_Apply(uint8_t cmd, uint8_t left_wall){
+  if (cmd&STEER_BRAKE){
+    Stop_Both_Wheels_Mode(STOP_BRAKE);
+  }
+  if (cmd&STEER_BACKOFF){
+    Trajectory_Push(-SPEED_35, -SPEED_35, BACKOFF_MS, BACKOFF_RAMP_MS);
+    return;
+  }
+  if (cmd&STEER_FOLLOW){
+    DIRECTION = FORWARD;
+    if (cmd&STEER_R){
+      Set_R_Speed(SPEED_35);
+      Start_R();
+    }else{
+      Stop_R();
+    }
+    if (cmd&STEER_L){
+      Set_L_Speed(SPEED_35);
+      Start_L();
+    }else{
+      Stop_L();
+    }
+  }
+  if (cmd&STEER_IN){
+    if (left_wall){
+      Move_Left_Forward();
+    }else{
+      Move_Right_Forward();
+    }
+  }
+  if (cmd&STEER_PIVOT){
+    Motion_Pivot(left_wall ? -CORNER_DEG : CORNER_DEG, SPEED_80);
+  }
+  if (cmd&STEER_AHEAD){
+    Move_Forward();
+  }
+}
+
+#if STEER_LUT
+#define STEER_DECIDE(policy,ahead,left,right) SteerLut[policy][STEER_CELL(ahead, left, right)]
+#else
+#define STEER_DECIDE(policy,ahead,left,right) Steer_Decide(policy, ahead, left, right)
+#endif
+
+// Carry out the command of the winning layer
+static void Cmd_Apply(const MotionCmd *cmd){
+  if (cmd->kind == CMD_BRAKE){
+    Stop_Both_Wheels_Mode(STOP_BRAKE);
+  }else if (cmd->kind == CMD_WHEELS){
+    Set_Wheels(cmd->left, cmd->right);
+  }else if (cmd->kind == CMD_BACKOFF){
+    Stop_Both_Wheels_Mode(STOP_BRAKE);
+    Trajectory_Push(cmd->left, cmd->right, cmd->arg, BACKOFF_RAMP_MS);
+  }else if (cmd->kind == CMD_PIVOT){
+    Motion_Pivot(cmd->arg, cmd->left);
+  }else if (cmd->kind == CMD_STEER){
+    Steer_Apply(cmd->arg, cmd->side);
+  }                     // CMD_HOLD, CMD_NONE: leave the motors alone
+}
+
+// Reading v as seen by code that compares it against thr, the centre
+// of h's band: moved just across thr when the comparator disagrees with
+// it. Readings past STOP_DIST are never held down, so the brake is not
+// delayed by the dwell.
+static uint16_t Held(Hyst *h, uint16_t v, uint16_t thr, uint32_t now){
+#if STEER_HYST
+  if (Hyst_Update(h, v, now)){
+    return (v < thr) ? thr : v;
+  }
+  return ((v >= thr)&&(v <= STOP_DIST)) ? thr - 1 : v;
+#else
+  return v;
+#endif
+}
+
+// Readings after a manoeuvre have no relation to the ones before it
+static void Held_Forget(void){
+  Hyst_Reset(&HAhead);
+  Hyst_Reset(&HLeft);
+  Hyst_Reset(&HRight);
+}
+
+//---------------- ST_IDLE ----------------
+static void Idle_Entry(void){
+  Halt_Motion();
+  LIGHT = RED;
+}
+static uint8_t Idle_Run(const SensorFrame *ir){
+  if (Stall_Detected()){
+    Stall_Clear();
+  }
+  if (Trajectory_Busy()){
+    return EV_NONE;     // coast once the ISR has flushed the queue
+  }
+  Stop_Both_Wheels_Mode(STOP_COAST);
+  Power_Deep_Request(); // nothing to do until a switch is pressed
+  return EV_NONE;
+}
+
+//---------------- ST_FOLLOW ----------------
+static void Follow_Entry(void){
+  Follow_Reset();
+  Search_Reset(Frame->stamp);
+  SideBraked = 0;
+  Hyst_Init(&HAhead, &FollowBand);
+  Hyst_Init(&HLeft, &FollowBand);
+  Hyst_Init(&HRight, &FollowBand);
+  Arbiter_Reset();
+  LIGHT = BLUE;
+}
+
+//---------------- ST_WALL_LEFT, ST_WALL_RIGHT ----------------
+static void Wall_Entry(void){
+  Wall_Reset();
+  Hyst_Init(&HAhead, &FrontBand);
+  Hyst_Init(&HLeft, &WallBand);
+  Hyst_Init(&HRight, &WallBand);
+  Arbiter_Reset();
+  LIGHT = GREEN;
+}
+static void Wall_Exit(void){
+  if (Motion_Status() == MOTION_BUSY){ // corner turn
+    Motion_Cancel();
+  }
+}
+
+//---------------- ST_SEARCH ----------------
+static void Search_Entry(void){
+  Search_Start(Frame->stamp);
+  SideBraked = 0;
+  Arbiter_Reset();
+  LIGHT = BLUE|GREEN;
+}
+
+//---------------- arbiter layers ----------------
+// Bumper hit. Normally EV_ESTOP has left the state before the layers run.
+static void EStop_Propose(const SensorFrame *ir, MotionCmd *cmd){
+  if (EStop_Tripped()){
+    cmd->kind = CMD_BRAKE;
+  }
+}
+// A corner pivot or back-off, once started, runs to completion
+static void Ballistic_Propose(const SensorFrame *ir, MotionCmd *cmd){
+  if ((Motion_Status() == MOTION_BUSY)||Trajectory_Busy()){
+    Held_Forget();
+    cmd->kind = CMD_HOLD;
+  }
+}
+// Something inside STOP_DIST: back off if it is ahead. Off to one side
+// brake once, then let the layers below steer away from it, so a wall
+// brushing a side sensor does not freeze the robot.
+static void Avoid_Propose(const SensorFrame *ir, MotionCmd *cmd){
+  if (ir->ahead > STOP_DIST){
+    cmd->kind = CMD_BACKOFF;
+    cmd->left = cmd->right = -SPEED_35;
+    cmd->arg = BACKOFF_MS;
+  }else if ((ir->left > STOP_DIST)||(ir->right > STOP_DIST)){
+    if (SideBraked == 0){
+      SideBraked = 1;
+      cmd->kind = CMD_BRAKE;
+    }
+  }else{
+    SideBraked = 0;
+  }
+}
+// Spin towards where the target was last seen
+static void Search_Propose(const SensorFrame *ir, MotionCmd *cmd){
+  cmd->kind = CMD_WHEELS;
+  Search_Spin(&cmd->left, &cmd->right);
+}
+static void Follow_Propose(const SensorFrame *ir, MotionCmd *cmd){
+#if FOLLOW_CONTROLLER == FOLLOW_PID
+  Follow_Step(ir->ahead, ir->right, ir->left, &cmd->left, &cmd->right);
+  cmd->kind = CMD_WHEELS;
+#else
+  uint16_t ahead, left, right;
+  ahead = Held(&HAhead, ir->ahead, FOLLOW_DIST, ir->stamp);
+  left = Held(&HLeft, ir->left, FOLLOW_DIST, ir->stamp);
+  right = Held(&HRight, ir->right, FOLLOW_DIST, ir->stamp);
+  cmd->kind = CMD_STEER;
+  cmd->side = 0;
+  cmd->arg = STEER_DECIDE(STEER_POLICY_FOLLOW, ahead, left, right);
+#endif
+}
+// The wall side comes from the state
+static void Wall_Propose(const SensorFrame *ir, MotionCmd *cmd){
+  uint8_t left_wall = (State == ST_WALL_LEFT);
+  uint16_t ahead, left = ir->left, right = ir->right;
+  ahead = Held(&HAhead, ir->ahead, WALL_DIST+1, ir->stamp);
+  if (left_wall){
+    left = Held(&HLeft, left, WALL_DIST, ir->stamp);
+  }else{
+    right = Held(&HRight, right, WALL_DIST, ir->stamp);
+  }
+#if WALL_CONTROLLER == WALL_PD
+  if (((left_wall ? left : right) >= WALL_DIST)&&(ahead > WALL_DIST)){ //Wall ahead too close to curve round
+    cmd->kind = CMD_PIVOT;
+    cmd->left = SPEED_80;
+    cmd->arg = left_wall ? -CORNER_DEG : CORNER_DEG;
+    return;
+  }
+  {
+    int16_t duty_in, duty_out;
+    Wall_Step(ir->ahead, left_wall ? ir->left : ir->right, &duty_in, &duty_out); // the loop wants the raw readings
+    cmd->kind = CMD_WHEELS;
+    cmd->left = left_wall ? duty_in : duty_out;
+    cmd->right = left_wall ? duty_out : duty_in;
+  }
+#else
+  cmd->kind = CMD_STEER;
+  cmd->side = left_wall;
+  cmd->arg = STEER_DECIDE(left_wall ? STEER_POLICY_WALL_LEFT : STEER_POLICY_WALL_RIGHT, ahead, left, right);
+#endif
+}
+
+// Highest priority first, indices are the LAYER_ numbers in Behavior.h
+static const Layer Layers[BEH_LAYERS] = {
+  [LAYER_ESTOP]     = {EStop_Propose,     0,            CHECK_BUDGET},
+  [LAYER_BALLISTIC] = {Ballistic_Propose, 0,            CHECK_BUDGET},
+  [LAYER_AVOID]     = {Avoid_Propose,     0,            CHECK_BUDGET},
+  [LAYER_SEARCH]    = {Search_Propose,    0,            CHECK_BUDGET},
+  [LAYER_FOLLOW]    = {Follow_Propose,    Follow_Reset, CONTROL_BUDGET},
+  [LAYER_WALL]      = {Wall_Propose,      Wall_Reset,   CONTROL_BUDGET},
+};
+
+// Layers enabled in each state, 0 for states that drive the motors themselves
+static const uint32_t StateLayers[BEH_STATES] = {
+  [ST_FOLLOW]     = (1u<<LAYER_ESTOP)|(1u<<LAYER_BALLISTIC)|(1u<<LAYER_AVOID)|(1u<<LAYER_FOLLOW),
+  [ST_WALL_LEFT]  = (1u<<LAYER_ESTOP)|(1u<<LAYER_BALLISTIC)|(1u<<LAYER_WALL),
+  [ST_WALL_RIGHT] = (1u<<LAYER_ESTOP)|(1u<<LAYER_BALLISTIC)|(1u<<LAYER_WALL),
+  [ST_SEARCH]     = (1u<<LAYER_ESTOP)|(1u<<LAYER_BALLISTIC)|(1u<<LAYER_AVOID)|(1u<<LAYER_SEARCH),
+};
+
+// Run action of the follower states
+static uint8_t Layers_Run(const SensorFrame *ir){
+  MotionCmd cmd;
+  Arbiter_Step(ir, StateLayers[State], &cmd);
+  Cmd_Apply(&cmd);
+  return EV_NONE;
+}
+
+static uint8_t Follow_Run(const SensorFrame *ir){
+  Search_Track(ir->ahead, ir->left, ir->right, ir->stamp);
+  if (Search_Lost(ir->stamp)){
+    return EV_LOST;
+  }
+  return Layers_Run(ir);
+}
+
+static uint8_t Search_Run(const SensorFrame *ir){
+  if (Search_Track(ir->ahead, ir->left, ir->right, ir->stamp)){
+    return EV_FOUND;
+  }
+  if (Search_TimedOut(ir->stamp)){
+    return EV_DONE;     // give up, stop
+  }
+  return Layers_Run(ir);
+}
+
+//---------------- ST_BACKOFF ----------------
+// A wheel jammed and the motors were cut: back away, then resume
+static void Backoff_Entry(void){
+  Halt_Motion();
+  Pushed = 0;
+}
+static uint8_t Backoff_Run(const SensorFrame *ir){
+  if (!Pushed){
+    if (Trajectory_Busy()){ // push once the flush is done
+      return EV_NONE;
+    }
+    Stall_Clear();
+    Trajectory_Push(-SPEED_60, -SPEED_60, STALL_BACKOFF_MS, BACKOFF_RAMP_MS);
+    Pushed = 1;
+    return EV_NONE;
+  }
+  return Trajectory_Busy() ? EV_NONE : EV_DONE;
+}
+
+//---------------- ST_ESTOP ----------------
+// Bumper hit: hardware already braked the wheels
+static void EStop_Entry(void){
+  Halt_Motion();
+  LIGHT = RED|BLUE;
+}
+static uint8_t EStop_Run(const SensorFrame *ir){
+  return EV_NONE;
+}
+
+//---------------- guards ----------------
+static uint8_t Left_Closer(void){ // on average over the last half second
+  return ModeSelect_Left();
+}
+static uint8_t Backoff_Started(void){ // a new stall while reversing: start over
+  return Pushed;
+}
+static uint8_t Rearmed(void){ // guards [ST_ESTOP][EV_SW1] only
+  return EStop_Rearm();
+}
+
+static const StateDef States[BEH_STATES] = {
+  [ST_IDLE]       = {Idle_Entry,    0,         Idle_Run,    0},
+  [ST_FOLLOW]     = {Follow_Entry,  0,         Follow_Run,  1},
+  [ST_WALL_LEFT]  = {Wall_Entry,    Wall_Exit, Layers_Run,  1},
+  [ST_WALL_RIGHT] = {Wall_Entry,    Wall_Exit, Layers_Run,  1},
+  [ST_BACKOFF]    = {Backoff_Entry, 0,         Backoff_Run, 0},
+  [ST_ESTOP]      = {EStop_Entry,   0,         EStop_Run,   0},
+  [ST_SEARCH]     = {Search_Entry,  0,         Search_Run,  0},
+};
+
+// Missing rows are {ST_NONE}: the event is ignored in that state
+static const Transition Table[BEH_STATES][BEH_EVENTS] = {
+  [ST_IDLE] = {
+    [EV_SW1]   = {ST_HISTORY},
+    [EV_ESTOP] = {ST_ESTOP},
+  },
+  [ST_FOLLOW] = {
+    [EV_SW1]   = {ST_IDLE},
+    [EV_SW2]   = {ST_WALL_LEFT, ST_WALL_RIGHT, Left_Closer},
+    [EV_ESTOP] = {ST_ESTOP},
+    [EV_STALL] = {ST_BACKOFF},
+    [EV_LOST]  = {ST_SEARCH},
+    [EV_AUTO_LEFT]  = {ST_WALL_LEFT},
+    [EV_AUTO_RIGHT] = {ST_WALL_RIGHT},
+  },
+  [ST_WALL_LEFT] = {
+    [EV_SW1]   = {ST_IDLE},
+    [EV_SW2]   = {ST_FOLLOW},
+    [EV_ESTOP] = {ST_ESTOP},
+    [EV_STALL] = {ST_BACKOFF},
+    [EV_AUTO_FOLLOW] = {ST_FOLLOW},
+    [EV_AUTO_RIGHT]  = {ST_WALL_RIGHT},
+  },
+  [ST_WALL_RIGHT] = {
+    [EV_SW1]   = {ST_IDLE},
+    [EV_SW2]   = {ST_FOLLOW},
+    [EV_ESTOP] = {ST_ESTOP},
+    [EV_STALL] = {ST_BACKOFF},
+    [EV_AUTO_FOLLOW] = {ST_FOLLOW},
+    [EV_AUTO_LEFT]   = {ST_WALL_LEFT},
+  },
+  [ST_BACKOFF] = {
+    [EV_SW1]   = {ST_IDLE},
+    [EV_ESTOP] = {ST_ESTOP},
+    [EV_STALL] = {ST_BACKOFF, ST_NONE, Backoff_Started},
+    [EV_DONE]  = {ST_HISTORY},
+  },
+  [ST_ESTOP] = {
+    [EV_SW1]   = {ST_HISTORY, ST_NONE, Rearmed}, // stays put while the bumper is held
+  },
+  [ST_SEARCH] = {
+    [EV_SW1]   = {ST_IDLE},
+    [EV_SW2]   = {ST_WALL_LEFT, ST_WALL_RIGHT, Left_Closer},
+    [EV_ESTOP] = {ST_ESTOP},
+    [EV_STALL] = {ST_BACKOFF},
+    [EV_FOUND] = {ST_FOLLOW},
+    [EV_DONE]  = {ST_IDLE},
+    [EV_AUTO_LEFT]  = {ST_WALL_LEFT},
+    [EV_AUTO_RIGHT] = {ST_WALL_RIGHT},
+  },
+};
+
+// Mode selector view of the states, MODESEL_NONE for the others
+static const uint8_t StateMode[BEH_STATES] = {
+  [ST_FOLLOW]     = MODESEL_FOLLOW,
+  [ST_SEARCH]     = MODESEL_FOLLOW,
+  [ST_WALL_LEFT]  = MODESEL_WALL_LEFT,
+  [ST_WALL_RIGHT] = MODESEL_WALL_RIGHT,
+};
+#if AUTO_MODE
+static const uint8_t ModeEvent[] = {
+  [MODESEL_FOLLOW]     = EV_AUTO_FOLLOW,
+  [MODESEL_WALL_LEFT]  = EV_AUTO_LEFT,
+  [MODESEL_WALL_RIGHT] = EV_AUTO_RIGHT,
+};
+#endif
+
+static void Dispatch(uint8_t event){
+  const Transition *t;
+  uint8_t from = State, next;
+  uint32_t start = CYCLES(), cycles;
+  t = &Table[from][event];
+  next = t->next;
+  if ((next != ST_NONE)&&t->guard&&!t->guard()){
+    next = t->alt;
+  }
+  if (next == ST_HISTORY){
+    next = History;
+  }
+  cycles = CYCLES() - start;
+  if (cycles > Behavior_DispatchCycles){
+    Behavior_DispatchCycles = cycles;
+  }
+  if (next == ST_NONE){
+    return;
+  }
+  if (States[from].exit){
+    States[from].exit();
+  }
+  State = next;
+  if (States[next].resumable){
+    History = next;
+  }
+  if (States[next].entry){
+    States[next].entry();
+  }
+  TRACE_LOG(TRACE_EV_TRANSITION, from, event, next);
+}
+
+void Behavior_Init(void){
+  ModeSelect_Init();
+  Arbiter_Init(Layers, BEH_LAYERS, SysTick_Cycles);
+  History = ST_FOLLOW;
+  State = ST_IDLE;
+  Idle_Entry();
+}
+
+void Behavior_Step(const SensorFrame *ir){
+  uint8_t button, event;
+  Frame = ir;
+  while (Buttons_Get(&button)){
+    Dispatch((button == BUTTON_SW1) ? EV_SW1 : EV_SW2);
+  }
+  if (EStop_Tripped()){
+    Dispatch(EV_ESTOP);
+  }
+  if (Stall_Detected()){
+    Dispatch(EV_STALL);
+  }
+#if AUTO_MODE
+  {
+    uint8_t mode = ModeSelect_Update(ir, StateMode[State]);
+    if (mode != StateMode[State]){
+      Dispatch(ModeEvent[mode]);
+    }
+  }
+#else
+  ModeSelect_Update(ir, StateMode[State]); // statistics for Left_Closer
+#endif
+  event = States[State].run(ir);
+  if (event != EV_NONE){
+    Dispatch(event);
+  }
+}
+
+uint8_t Behavior_State(void){
+  return State;
+}
@@ -0,0 +1,80 @@
+// Behavior.h
+// Runs on TM4C123
+// Table-driven behaviour state machine for the robot.
+// Every state has entry, exit and run actions; every (state, event)
+// pair has one transition row with an optional guard. All of it is
+// const, so it lives in flash. Dispatch is one table lookup; a
+// new behaviour is a new state, a row in States[] and its column in
+// Table[] (Behavior.c).
+// Each control tick Behavior_Step() turns switch presses, the e-stop
+// and stall flags and, with AUTO_MODE, the mode selector's choice
+// (ModeSelect.h) into events, dispatches them, then runs the current
+// state with the sensor frame. With TRACE defined every transition is
+// logged with Trace_Log().
+// The follower states drive the motors through the subsumption layers
+// below (Arbiter.h): each state enables a set of layers, and the
+// highest enabled layer with something to say wins the tick. Per-layer
+// activation counts and run times are in Arbiter_Stats(LAYER_x).
+
+#ifndef BEHAVIOR_H
+#define BEHAVIOR_H
+#include <stdint.h>
+#include "Sensors.h"
+
+// States, 0 is reserved
+#define ST_NONE       0             // in a transition: ignore the event
+#define ST_IDLE       1             // stopped, waiting for SW1
+#define ST_FOLLOW     2             // mode 1, object follower
+#define ST_WALL_LEFT  3             // mode 2, left wall follower
+#define ST_WALL_RIGHT 4             // mode 3, right wall follower
+#define ST_BACKOFF    5             // reversing after a wheel stall
+#define ST_ESTOP      6             // bumper hit, waiting for SW1 to re-arm
+#define ST_SEARCH     7             // mode 1, target lost: spinning towards where it was last seen
+#define BEH_STATES    8
+#define ST_HISTORY    0xFF          // in a transition: the last follower state
+
+// Arbiter layers, highest priority first
+#define LAYER_ESTOP     0           // bumper hit: brake
+#define LAYER_BALLISTIC 1           // pivot or back-off in progress: hands off
+#define LAYER_AVOID     2           // ST_FOLLOW, ST_SEARCH: something inside STOP_DIST
+#define LAYER_SEARCH    3           // spin towards the side the target was last seen on
+#define LAYER_FOLLOW    4           // object follower, Follow.h
+#define LAYER_WALL      5           // wall follower, Wall.h
+#define BEH_LAYERS      6
+
+// Events
+#define EV_SW1    0                 // start/stop switch
+#define EV_SW2    1                 // mode switch
+#define EV_ESTOP  2                 // e-stop tripped
+#define EV_STALL  3                 // wheel stall detected
+#define EV_DONE   4                 // the current state finished its job
+#define EV_LOST   5                 // nothing in view for SEARCH_LOST_MS
+#define EV_FOUND  6                 // something came into view
+#define EV_AUTO_FOLLOW 7            // ModeSelect.h: switch to object following
+#define EV_AUTO_LEFT   8            //   to the left wall
+#define EV_AUTO_RIGHT  9            //   to the right wall
+#define BEH_EVENTS 10
+
+// Tunables, here so the host checks (host/) use the same values
+#define BACKOFF_MS      200         // object follower reverse when the object is too close
+#define BACKOFF_RAMP_MS 50
+#define FOLLOW_HYST     40          // STEER_HYST band, ADC counts each side of FOLLOW_DIST
+#define WALL_HYST       30          //   and of WALL_DIST
+#define STEER_DWELL_MS  20          //   minimum time between changes
+
+// Start in ST_IDLE, resuming into ST_FOLLOW
+void Behavior_Init(void);
+
+// One control tick with a consistent sensor frame
+void Behavior_Step(const SensorFrame *ir);
+
+// Current state, safe to read from any context
+uint8_t Behavior_State(void);
+
+// Worst cost of one dispatch (lookup and guard, not the entry and
+// exit actions) in core clock cycles, to be read from the debugger.
+// Counted by hand from the C, not yet measured: about 15 cycles for a
+// transition without a guard, about 40 through Left_Closer().
+extern uint32_t Behavior_DispatchCycles;
+
+#endif
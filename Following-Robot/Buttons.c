@@ -0,0 +1,79 @@
+// Buttons.c
+// Runs on TM4C123
+// Switch debouncing with a one-shot timer, see Buttons.h.
+
+#include <stdint.h>
+#include "Buttons.h"
+#include "FIFO.h"
+#include "PLL.h"
+#include "Power.h"
+#include "tm4c123gh6pm.h"
+
+AddIndexFifo(Button, BUTTON_FIFO_SIZE, uint8_t, 1, 0)
+
+#define SWITCHES (BUTTON_SW1|BUTTON_SW2)
+
+static volatile uint8_t Pending;  // switches with an edge waiting for the timer
+static uint32_t Lost;
+
+void Buttons_Init(void){
+  volatile uint32_t delay;
+  ButtonFifo_Init();
+  Pending = 0;
+  SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R0; // activate timer0
+  delay = SYSCTL_RCGCTIMER_R;
+  TIMER0_CTL_R = 0;                          // disable timer0A during setup
+  TIMER0_CFG_R = TIMER_CFG_32_BIT_TIMER;
+  TIMER0_TAMR_R = TIMER_TAMR_TAMR_1_SHOT;
+  TIMER0_TAILR_R = BUS_CLOCK/1000*DEBOUNCE_MS - 1;
+  TIMER0_TAPR_R = 0;
+  TIMER0_ICR_R = TIMER_ICR_TATOCINT;
+  TIMER0_IMR_R = TIMER_IMR_TATOIM;
+  NVIC_PRI4_R = (NVIC_PRI4_R&0x1FFFFFFF)|0xA0000000; // bits 31-29 for Timer0A, priority 5 like port F
+  NVIC_EN0_R |= 0x00080000;                  // enable interrupt 19 in NVIC
+}
+
+// Edge on PF0/PF4: hold off further edges and start the debounce window
+void GPIOPortF_Handler(void){
+  uint8_t edges = GPIO_PORTF_RIS_R&SWITCHES;
+  GPIO_PORTF_ICR_R = edges;
+  GPIO_PORTF_IM_R &= ~SWITCHES;
+  Pending |= edges;
+  TIMER0_TAILR_R = BUS_CLOCK/1000*DEBOUNCE_MS - 1;
+  TIMER0_CTL_R = TIMER_CTL_TAEN;             // one-shot, stops itself
+  Power_Deep_Cancel();                       // stay awake for the result
+}
+
+// Debounce window over: post switches that settled released, re-arm
+void Timer0A_Handler(void){
+  uint8_t settled;
+  TIMER0_ICR_R = TIMER_ICR_TATOCINT;
+  settled = Pending&GPIO_PORTF_DATA_R;       // released reads high (pull-up)
+  Pending = 0;
+  if (settled&BUTTON_SW1){
+    if (!ButtonFifo_Put(BUTTON_SW1)){
+      Lost++;
+    }
+  }
+  if (settled&BUTTON_SW2){
+    if (!ButtonFifo_Put(BUTTON_SW2)){
+      Lost++;
+    }
+  }
+  GPIO_PORTF_ICR_R = SWITCHES;               // forget bounces in the window
+  GPIO_PORTF_IM_R |= SWITCHES;
+}
+
+int Buttons_Get(uint8_t *event){
+  return ButtonFifo_Get(event);
+}
+
+void Buttons_Flush(void){
+  uint8_t event;
+  while (Pending){}                          // Timer0A_Handler clears it
+  while (ButtonFifo_Get(&event)){}
+}
+
+uint32_t Buttons_Lost(void){
+  return Lost;
+}
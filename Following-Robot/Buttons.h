@@ -0,0 +1,34 @@
+// Buttons.h
+// Runs on TM4C123
+// Debounced on-board switches SW1 (PF4) and SW2 (PF0).
+// Port F is set up by SwitchLED_Init() to interrupt on release (rising
+// edge). GPIOPortF_Handler only disarms the edge interrupt and starts
+// Timer0A as a one-shot. When it times out, a switch that is still
+// released is a confirmed event, posted to a lock-free FIFO; bounces
+// inside the window are ignored. The control code takes the events
+// with Buttons_Get() at a point where it owns mode and active.
+
+#ifndef BUTTONS_H
+#define BUTTONS_H
+#include <stdint.h>
+
+#define BUTTON_SW2 0x01             // PF0, mode select
+#define BUTTON_SW1 0x10             // PF4, start/stop
+#define DEBOUNCE_MS 20
+#define BUTTON_FIFO_SIZE 8
+
+// Timer0A one-shot and the event queue. Call after SwitchLED_Init().
+void Buttons_Init(void);
+
+// Take the oldest confirmed event
+// Output: 1 with BUTTON_SW1 or BUTTON_SW2 in *event, 0 if none
+int Buttons_Get(uint8_t *event);
+
+// Wait for a debounce window in progress to close, then drop every
+// queued event, e.g. the release of a switch held through reset
+void Buttons_Flush(void);
+
+// Events dropped because the queue was full
+uint32_t Buttons_Lost(void);
+
+#endif
@@ -0,0 +1,121 @@
+// Calibrate.c
+// Runs on TM4C123
+// Automatic wheel trim calibration for straight-line driving.
+// The left wheel is the reference. The right wheel is adjusted until
+// the right IR sensor reads the same distance at the end of a straight
+// run as at the start, at every trim breakpoint. The linear part of the
+// resulting correction is then moved into the gain term.
+
+#include <stdint.h>
+#include "Calibrate.h"
+#include "ADC0SS2.h"
+#include "Motors.h"
+#include "Params.h"
+#include "SysTickInts.h"
+
+#define TRIM_SEG_WIDTH (PERIOD/TRIM_SEGMENTS)
+
+static void Wait_ms(uint32_t ms){
+  uint32_t start = Ticks;
+  while((Ticks - start) < MS_TO_TICKS(ms)){};
+}
+
+// Right IR reading with the median filter history refreshed
+static uint16_t Read_Right(void){
+  uint16_t ahead, right, left;
+  uint8_t i;
+  for(i=0; i<3; i++){
+    ReadADCMedianFilter(&ahead, &right, &left);
+  }
+  return right;
+}
+
+static void Drive(unsigned long direction, uint16_t left_duty, uint16_t right_duty){
+  DIRECTION = direction;
+  Set_L_Speed(left_duty);
+  Set_R_Speed(right_duty);
+  Start_Both_Wheels();
+}
+
+// Raise the duty on one wheel until the robot starts to turn.
+// left selects the wheel; the other wheel is held stopped.
+static uint16_t Find_Deadband(uint8_t left){
+  uint16_t start = Read_Right();
+  uint16_t duty, now;
+  int32_t change;
+  for(duty = PERIOD/100; duty < PERIOD/2; duty += PERIOD/100){
+    DIRECTION = FORWARD;
+    if(left){
+      Set_L_Speed(duty);
+      Start_L();
+    }else{
+      Set_R_Speed(duty);
+      Start_R();
+    }
+    Wait_ms(CAL_STEP_MS);
+    now = Read_Right();
+    change = (int32_t)now - start;
+    if((change > CAL_MOVE_ADC)||(change < -CAL_MOVE_ADC)){
+      break;
+    }
+  }
+  Stop_Both_Wheels_Mode(STOP_BRAKE);
+  Wait_ms(200);
+  return duty;
+}
+
+int Calibrate_Wheels(void){
+  uint8_t i, trial;
+  uint16_t duty, before, after;
+  int32_t corr, top, gain;
+
+  Params_Default();                     // measure with the identity map
+
+  // Deadband: turn toward the wall on the left wheel, then back on the right.
+  // Both deadbands are measured; only their difference matters for straight
+  // driving, so the smaller one is treated as zero.
+  Params.left.deadband = Find_Deadband(1);
+  Params.right.deadband = Find_Deadband(0);
+  if(Params.left.deadband < Params.right.deadband){
+    Params.right.deadband -= Params.left.deadband;
+    Params.left.deadband = 0;
+  }else{
+    Params.left.deadband -= Params.right.deadband;
+    Params.right.deadband = 0;
+  }
+
+  // Straight-line correction of the right wheel at each breakpoint.
+  // Drifting toward the wall (reading grows) means the left wheel is
+  // slower, so the right correction goes down.
+  for(i=1; i<=TRIM_SEGMENTS; i++){
+    duty = (i == TRIM_SEGMENTS) ? SPEED_98 : TRIM_SEG_WIDTH*i;
+    for(trial=0; trial<CAL_TRIALS; trial++){
+      before = Read_Right();
+      Drive(FORWARD, duty, duty);
+      Wait_ms(CAL_RUN_MS);
+      Stop_Both_Wheels_Mode(STOP_BRAKE);
+      Wait_ms(200);
+      after = Read_Right();
+      corr = Params.right.corr[i] - (((int32_t)after - before)*TRIM_SEG_WIDTH)/CAL_DRIFT_SCALE;
+      if(corr > TRIM_SEG_WIDTH) corr = TRIM_SEG_WIDTH;
+      if(corr < -TRIM_SEG_WIDTH) corr = -TRIM_SEG_WIDTH;
+      Params.right.corr[i] = (int16_t)corr;
+      Drive(BACKWARD, duty, duty);      // return to the starting point
+      Wait_ms(CAL_RUN_MS);
+      Stop_Both_Wheels_Mode(STOP_BRAKE);
+      Wait_ms(200);
+    }
+  }
+
+  // Move the straight-line part of the correction into the gain
+  top = PERIOD;
+  gain = ((top + Params.right.corr[TRIM_SEGMENTS])*TRIM_GAIN_ONE)/top;
+  Params.right.gain = (uint16_t)gain;
+  for(i=0; i<=TRIM_SEGMENTS; i++){
+    duty = TRIM_SEG_WIDTH*i;
+    Params.right.corr[i] = (int16_t)(((duty + Params.right.corr[i])*TRIM_GAIN_ONE)/gain - duty);
+  }
+
+  Stop_Both_Wheels_Mode(STOP_COAST);
+  return Params_Save();
+}
@@ -0,0 +1,18 @@
+// Calibrate.h
+// Runs on TM4C123
+// Automatic wheel trim calibration for straight-line driving.
+// Place the robot parallel to a straight wall on its right side,
+// about 15 cm away, with at least 1 m of clear floor ahead, then
+// hold SW1 (PF4) during reset. The results are written to Params
+// and saved to EEPROM.
+
+#define CAL_RUN_MS       1200  // length of each straight-line trial
+#define CAL_TRIALS       3     // trials per trim breakpoint
+#define CAL_STEP_MS      40    // deadband search: time per duty step
+#define CAL_MOVE_ADC     60    // deadband search: side reading change that means the robot moved
+#define CAL_DRIFT_SCALE  1024  // ADC drift per trial that moves a breakpoint by one segment width
+
+// Run the calibration. Blocks for about a minute.
+// Needs SysTick running and interrupts enabled.
+// Output: 1 if the new trim was saved to EEPROM
+int Calibrate_Wheels(void);
@@ -0,0 +1,18 @@
+// CycleCount.h
+// Runs on TM4C123
+// Core clock cycle counter from the Cortex-M4 DWT unit.
+// CYCLES() wraps every 2^32 cycles (268 s at 16 MHz); use differences only.
+
+#ifndef CYCLECOUNT_H
+#define CYCLECOUNT_H
+
+#define DEMCR_R      (*((volatile unsigned long *)0xE000EDFC)) // Debug Exception and Monitor Control
+#define DWT_CTRL_R   (*((volatile unsigned long *)0xE0001000))
+#define DWT_CYCCNT_R (*((volatile unsigned long *)0xE0001004))
+#define DEMCR_TRCENA      0x01000000  // enable DWT and ITM
+#define DWT_CTRL_CYCCNTENA 0x00000001 // enable CYCCNT
+
+#define CycleCount_Init() do{ DEMCR_R |= DEMCR_TRCENA; DWT_CYCCNT_R = 0; DWT_CTRL_R |= DWT_CTRL_CYCCNTENA; }while(0)
+#define CYCLES() ((uint32_t)DWT_CYCCNT_R)
+
+#endif
@@ -0,0 +1,69 @@
+// EEPROM.c
+// Runs on TM4C123
+// Word access to the 2 KB on-chip EEPROM (32 blocks of 16 words).
+// Used to keep robot-specific parameters across resets, see Params.h.
+
+#include <stdint.h>
+#include "EEPROM.h"
+#include "tm4c123gh6pm.h"
+
+static void EEPROM_Wait(void){
+  while(EEPROM_EEDONE_R&EEPROM_EEDONE_WORKING){};
+}
+
+// Turn on the EEPROM module and wait for it to finish any pending operation
+// Sequence from the TM4C123 datasheet, section 8.2.4.1
+int EEPROM_Init(void){
+  volatile uint32_t delay;
+  SYSCTL_RCGCEEPROM_R |= SYSCTL_RCGCEEPROM_R0;  // 1) activate EEPROM
+  delay = SYSCTL_RCGCEEPROM_R;                  //    at least 6 cycles before access
+  delay = SYSCTL_RCGCEEPROM_R;
+  EEPROM_Wait();                                // 2) wait for power-on operations
+  if(EEPROM_EESUPP_R&(EEPROM_EESUPP_PRETRY|EEPROM_EESUPP_ERETRY)){
+    return 0;                                   // 3) a previous write was interrupted
+  }
+  SYSCTL_SREEPROM_R = SYSCTL_SREEPROM_R0;       // 4) reset the module
+  delay = SYSCTL_SREEPROM_R;
+  SYSCTL_SREEPROM_R = 0;
+  while((SYSCTL_PREEPROM_R&SYSCTL_PREEPROM_R0) == 0){};
+  EEPROM_Wait();                                // 5) wait again after the reset
+  if(EEPROM_EESUPP_R&(EEPROM_EESUPP_PRETRY|EEPROM_EESUPP_ERETRY)){
+    return 0;
+  }
+  return 1;
+}
+
+// Read count 32-bit words starting at word offset of block
+void EEPROM_Read(uint32_t block, uint32_t offset, uint32_t *data, uint32_t count){
+  EEPROM_EEBLOCK_R = block;
+  EEPROM_EEOFFSET_R = offset;
+  while(count){
+    *data++ = EEPROM_EERDWRINC_R;               // offset increments after each access
+    count--;
+    offset++;
+    if((offset == EEPROM_BLOCK_WORDS)&&count){  // offset wraps inside a block
+      EEPROM_EEBLOCK_R = ++block;
+      EEPROM_EEOFFSET_R = offset = 0;
+    }
+  }
+}
+
+// Write count 32-bit words starting at word offset of block
+int EEPROM_Write(uint32_t block, uint32_t offset, const uint32_t *data, uint32_t count){
+  EEPROM_EEBLOCK_R = block;
+  EEPROM_EEOFFSET_R = offset;
+  while(count){
+    EEPROM_EERDWRINC_R = *data++;
+    EEPROM_Wait();
+    if(EEPROM_EEDONE_R){                        // any bit left set is an error
+      return 0;
+    }
+    count--;
+    offset++;
+    if((offset == EEPROM_BLOCK_WORDS)&&count){
+      EEPROM_EEBLOCK_R = ++block;
+      EEPROM_EEOFFSET_R = offset = 0;
+    }
+  }
+  return 1;
+}
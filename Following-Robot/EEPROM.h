@@ -0,0 +1,21 @@
+// EEPROM.h
+// Runs on TM4C123
+// Word access to the 2 KB on-chip EEPROM (32 blocks of 16 words).
+// Used to keep robot-specific parameters across resets, see Params.h.
+
+#include <stdint.h>
+
+#define EEPROM_BLOCK_WORDS 16
+
+// Turn on the EEPROM module and wait for it to finish any pending operation
+// Output: 1 if the EEPROM is ready, 0 if it reported an unrecoverable error
+int EEPROM_Init(void);
+
+// Read count 32-bit words starting at word offset of block
+// Reads continue into the next block when offset reaches 16
+void EEPROM_Read(uint32_t block, uint32_t offset, uint32_t *data, uint32_t count);
+
+// Write count 32-bit words starting at word offset of block
+// Busy-waits about 110 us per word while the EEPROM programs
+// Output: 1 on success, 0 if the EEPROM reported a programming error
+int EEPROM_Write(uint32_t block, uint32_t offset, const uint32_t *data, uint32_t count);
@@ -0,0 +1,66 @@
+// EStop.c
+// Runs on TM4C123
+// Hardware emergency stop through the PWM0 fault input.
+
+#include <stdint.h>
+#include "EStop.h"
+#include "Motors.h"
+#include "tm4c123gh6pm.h"
+
+#define ESTOP_PIN (*((volatile unsigned long *)0x40007010)) // PD2 only
+
+static volatile uint8_t Tripped;
+static volatile uint32_t Count;
+
+void EStop_Init(void){
+  SYSCTL_RCGCGPIO_R |= 0x08;               // 1) activate port D
+  while((SYSCTL_RCGCGPIO_R&0x08) == 0){};
+  GPIO_PORTD_DIR_R &= ~0x04;               // 2) PD2 in
+  GPIO_PORTD_AFSEL_R |= 0x04;              //    M0FAULT0
+  GPIO_PORTD_PCTL_R = (GPIO_PORTD_PCTL_R&0xFFFFF0FF)|0x00000400;
+  GPIO_PORTD_AMSEL_R &= ~0x04;
+  GPIO_PORTD_PUR_R |= 0x04;                //    switch pulls it to ground
+  GPIO_PORTD_DEN_R |= 0x04;
+  PWM0_FAULTVAL_R &= ~(PWM_FAULTVAL_PWM2|PWM_FAULTVAL_PWM3); // 3) outputs low in a fault
+  PWM0_FAULT_R |= PWM_FAULT_FAULT2|PWM_FAULT_FAULT3;         //    use FAULTVAL on PB4, PB5
+  PWM0_1_FLTSEN_R = PWM_1_FLTSEN_FAULT0;   // 4) fault 0 is active low
+  PWM0_1_FLTSRC0_R = PWM_1_FLTSRC0_FAULT0; //    generator 1 watches fault 0
+  PWM0_1_FLTSTAT0_R = PWM_1_FLTSTAT0_FAULT0; //  clear anything seen during setup
+  PWM0_1_CTL_R |= PWM_1_CTL_FLTSRC|PWM_1_CTL_LATCH; // 5) fault source, latched
+  PWM0_ISC_R = PWM_ISC_INTFAULT1;
+  PWM0_INTEN_R |= PWM_INTEN_INTFAULT1;     // 6) interrupt on generator 1 fault
+  NVIC_PRI2_R = (NVIC_PRI2_R&0xFFFF1FFF)|0x00002000; // bits 15-13 for PWM0 fault, priority 1
+  NVIC_EN0_R = 1<<9;                       //    enable interrupt 9 in NVIC
+  Tripped = 0;
+}
+
+// The outputs are already low when this runs; it only records the event
+// and stops software from restarting the wheels.
+void PWM0Fault_Handler(void){
+  PWM0_INTEN_R &= ~PWM_INTEN_INTFAULT1;    // re-enabled by EStop_Rearm()
+  PWM0_ISC_R = PWM_ISC_INTFAULT1;
+  Motors_Lockout(LOCKOUT_ESTOP, 1);
+  Stop_Both_Wheels();
+  Tripped = 1;
+  Count++;
+}
+
+uint8_t EStop_Tripped(void){
+  return Tripped;
+}
+
+int EStop_Rearm(void){
+  if (ESTOP_PIN == 0){                     // switch still closed
+    return 0;
+  }
+  PWM0_1_FLTSTAT0_R = PWM_1_FLTSTAT0_FAULT0; // release the latched fault
+  PWM0_ISC_R = PWM_ISC_INTFAULT1;
+  Tripped = 0;
+  Motors_Lockout(LOCKOUT_ESTOP, 0);
+  PWM0_INTEN_R |= PWM_INTEN_INTFAULT1;
+  return 1;
+}
+
+uint32_t EStop_Count(void){
+  return Count;
+}
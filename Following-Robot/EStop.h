@@ -0,0 +1,30 @@
+// EStop.h
+// Runs on TM4C123
+// Hardware emergency stop through the PWM0 fault input.
+// A bumper or e-stop switch between PD2 (M0FAULT0) and ground trips
+// the PWM module directly: both wheel outputs (M0PWM2/PB4, M0PWM3/PB5)
+// are forced low with no software involved, which with nSLEEP high
+// brakes both motors. The fault is latched in hardware, and
+// PWM0Fault_Handler additionally locks the motors out in software.
+// EStop_Rearm() releases the latch once the switch is open again.
+
+#ifndef ESTOP_H
+#define ESTOP_H
+#include <stdint.h>
+
+// Configure PD2 as M0FAULT0 (active low, pull-up) and arm the fault
+// on PWM generator 1. Call after Wheels_PWM_Init().
+void EStop_Init(void);
+
+// 1 from the moment the fault trips until a successful EStop_Rearm()
+uint8_t EStop_Tripped(void);
+
+// Clear the latched fault and the motor lockout. Call only on an
+// operator request (SW1): the control loop never re-arms a trip itself.
+// Output: 1 if re-armed, 0 if the switch is still closed (still tripped)
+int EStop_Rearm(void);
+
+// Number of faults since reset
+uint32_t EStop_Count(void);
+
+#endif
@@ -0,0 +1,49 @@
+// FIFO.h
+// Runs on any microcontroller
+// Lock-free single producer, single consumer index FIFO.
+// One side (e.g. main) only calls Put, the other (e.g. an ISR) only
+// calls Get. PutI is written only by the producer and GetI only by the
+// consumer, so no interrupts need to be disabled.
+// SIZE must be a power of 2. The FIFO holds up to SIZE elements.
+// Usage, at file scope in one .c file:
+//   AddIndexFifo(Tx, 16, Segment, 1, 0)
+// creates TxFifo_Init, TxFifo_Put, TxFifo_Get and TxFifo_Size.
+
+#ifndef FIFO_H
+#define FIFO_H
+#include <stdint.h>
+
+// Keeps the compiler from moving the element copy past the index update
+#define FIFO_BARRIER() __asm volatile("" ::: "memory")
+
+#define AddIndexFifo(NAME,SIZE,TYPE,SUCCESS,FAIL) \
+static uint32_t volatile NAME ## PutI;            \
+static uint32_t volatile NAME ## GetI;            \
+static TYPE NAME ## Fifo [SIZE];                  \
+void NAME ## Fifo_Init(void){                     \
+  NAME ## PutI = NAME ## GetI = 0;                \
+}                                                 \
+int NAME ## Fifo_Put(TYPE data){                  \
+  if((NAME ## PutI - NAME ## GetI) >= (SIZE)){    \
+    return(FAIL);                                 \
+  }                                               \
+  NAME ## Fifo[NAME ## PutI&((SIZE)-1)] = data;   \
+  FIFO_BARRIER();                                 \
+  NAME ## PutI = NAME ## PutI + 1;                \
+  return(SUCCESS);                                \
+}                                                 \
+int NAME ## Fifo_Get(TYPE *datapt){               \
+  if(NAME ## PutI == NAME ## GetI){               \
+    return(FAIL);                                 \
+  }                                               \
+  FIFO_BARRIER();                                 \
+  *datapt = NAME ## Fifo[NAME ## GetI&((SIZE)-1)];\
+  FIFO_BARRIER();                                 \
+  NAME ## GetI = NAME ## GetI + 1;                \
+  return(SUCCESS);                                \
+}                                                 \
+uint32_t NAME ## Fifo_Size(void){                 \
+  return(NAME ## PutI - NAME ## GetI);            \
+}
+
+#endif
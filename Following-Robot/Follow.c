@@ -0,0 +1,56 @@
+// Follow.c
+// Runs on TM4C123, and on a host PC for testing
+// PID object follower, see Follow.h.
+
+#include <stdint.h>
+#include "Follow.h"
+#include "Pid.h"
+#include "Tracker.h"
+#include "Motors.h"
+#include "ADC0SS2.h"
+
+// Range: error in ADC counts -> forward duty
+// Turn: right-left imbalance in ADC counts -> differential duty
+static const PidGains RangeGains[] = {
+  //  kp   ki     kd  d_alpha  out_min    out_max
+  { 1000,   0, 10000, 64, -SPEED_35, SPEED_60},  // FOLLOW_GAINS_SOFT
+  { 1600,   1, 30000, 64, -SPEED_35, SPEED_60},  // FOLLOW_GAINS_MEDIUM
+  { 2400,   2, 60000, 64, -SPEED_35, SPEED_60},  // FOLLOW_GAINS_FIRM
+};
+static const PidGains TurnGains[] = {
+  {  300,   0,  4000, 64, -SPEED_35, SPEED_35},
+  {  600,   0,  6000, 64, -SPEED_35, SPEED_35},
+  {  900,   0,  8000, 64, -SPEED_35, SPEED_35},
+};
+
+static Pid Range = {&RangeGains[FOLLOW_GAINS]};
+static Pid Turn = {&TurnGains[FOLLOW_GAINS]};
+
+#if FOLLOW_PREDICT
+// Front reading in ADC counts. Heavy smoothing: the Sharp sensors only
+// refresh every ~38 ms, so at CONTROL_HZ most steps see the same
+// reading plus ADC noise.
+static const TrackerGains RangeTrackGains = {200, 2};
+static Tracker RangeTrack = {&RangeTrackGains};
+#endif
+
+void Follow_Reset(void){
+  Pid_Reset(&Range);
+  Pid_Reset(&Turn);
+#if FOLLOW_PREDICT
+  Tracker_Reset(&RangeTrack);
+#endif
+}
+
+void Follow_Step(uint16_t ahead, uint16_t right, uint16_t left, int16_t *duty_l, int16_t *duty_r){
+  int32_t range = ahead, bearing = (int32_t)left - (int32_t)right;
+  int32_t v, w;
+#if FOLLOW_PREDICT
+  Tracker_Update(&RangeTrack, range);
+  range = Tracker_Predict(&RangeTrack, FOLLOW_LEAD);
+#endif
+  v = Pid_Update(&Range, FOLLOW_DIST, range);
+  w = Pid_Update(&Turn, 0, bearing); // right closer: w > 0, right wheel faster
+  *duty_l = (int16_t)(v - w);
+  *duty_r = (int16_t)(v + w);
+}
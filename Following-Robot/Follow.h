@@ -0,0 +1,54 @@
+// Follow.h
+// Runs on TM4C123, and on a host PC for testing
+// Object follower for mode 1.
+// FOLLOW_PID: two PID loops turn the IR readings into signed wheel
+// duties every control tick. The range loop holds the front reading at
+// FOLLOW_DIST, driving forward when the object is farther and backing
+// up when it is closer. The turn loop balances the right and left
+// readings. Wheel duty = range output -/+ turn output.
+// FOLLOW_BANGBANG: the original on/off logic in object_steering, kept
+// for comparison.
+// The gain set is picked at compile time from FOLLOW_GAINS_SOFT,
+// _MEDIUM and _FIRM, all tuned for CONTROL_HZ = 500.
+// FOLLOW_PREDICT=1 runs the front reading through an alpha-beta
+// tracker (Tracker.h) and gives the range loop the estimate
+// FOLLOW_LEAD control periods ahead instead of the raw reading. The
+// left-right balance is left alone: with two narrow cones it is close
+// to an on/off signal and has no rate worth estimating.
+// It is on by default: in host/track.c, which runs both, it holds range
+// 18.0 mm rms against 18.9 without and changes the wheel duties a third
+// as much (11480/s against 35304/s), for bearing 1.86 deg rms against
+// 1.73, on a straight walk.
+// host/follow.c runs the loop against a model of the robot.
+
+#ifndef FOLLOW_H
+#define FOLLOW_H
+#include <stdint.h>
+
+#define FOLLOW_BANGBANG 0
+#define FOLLOW_PID      1
+#ifndef FOLLOW_CONTROLLER
+#define FOLLOW_CONTROLLER FOLLOW_PID
+#endif
+
+#define FOLLOW_GAINS_SOFT   0       // no integral: no overshoot, lags a moving target
+#define FOLLOW_GAINS_MEDIUM 1
+#define FOLLOW_GAINS_FIRM   2       // fastest settling and tracking, most sensitive to IR noise
+#ifndef FOLLOW_GAINS
+#define FOLLOW_GAINS FOLLOW_GAINS_MEDIUM
+#endif
+
+#ifndef FOLLOW_PREDICT
+#define FOLLOW_PREDICT 1
+#endif
+#define FOLLOW_LEAD 1               // control periods
+
+// Forget the loop state. Call whenever something other than
+// Follow_Step() has been driving the wheels.
+void Follow_Reset(void);
+
+// One control step from the IR readings (larger is closer)
+// Output: signed wheel duties for Set_Wheels()
+void Follow_Step(uint16_t ahead, uint16_t right, uint16_t left, int16_t *duty_l, int16_t *duty_r);
+
+#endif
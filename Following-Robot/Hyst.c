@@ -0,0 +1,35 @@
+// Hyst.c
+// Runs on TM4C123, and on a host PC for testing
+// Comparator with hysteresis and dwell, see Hyst.h.
+
+#include <stdint.h>
+#include "Hyst.h"
+
+void Hyst_Init(Hyst *h, const HystBand *b){
+  h->b = b;
+  h->flips = 0;
+  Hyst_Reset(h);
+}
+
+void Hyst_Reset(Hyst *h){
+  h->out = 0;
+  h->primed = 0;
+}
+
+uint8_t Hyst_Update(Hyst *h, uint16_t v, uint32_t now){
+  const HystBand *b = h->b;
+  uint8_t want;
+  if (!h->primed){                  // no history: follow the input
+    h->out = (v >= b->on);
+    h->since = now;
+    h->primed = 1;
+    return h->out;
+  }
+  want = h->out ? (v >= b->off) : (v >= b->on);
+  if ((want != h->out)&&((now - h->since) >= b->dwell)){
+    h->out = want;
+    h->since = now;
+    h->flips++;
+  }
+  return h->out;
+}
@@ -0,0 +1,41 @@
+// Hyst.h
+// Runs on TM4C123, and on a host PC for testing
+// Threshold comparator with hysteresis and a minimum dwell time.
+// The output goes high when the input reaches on and low when it drops
+// below off, so noise narrower than on-off cannot toggle it. After each
+// change the output holds for at least dwell time units, which stops
+// noise wider than the band from toggling it faster than that.
+// The first update after a reset takes the output straight from the
+// input, with no dwell.
+// host/hyst.c checks it and replays noisy traces through it.
+
+#ifndef HYST_H
+#define HYST_H
+#include <stdint.h>
+
+typedef struct {
+  uint16_t on;                      // output goes high at input >= on
+  uint16_t off;                     // output goes low at input < off, off <= on
+  uint16_t dwell;                   // minimum time between changes
+} HystBand;
+
+typedef struct {
+  const HystBand *b;
+  uint32_t since;                   // time of the last change
+  uint32_t flips;                   // output changes since Hyst_Init
+  uint8_t out;
+  uint8_t primed;                   // out is valid
+} Hyst;
+
+// Bind a band and clear the state and the flip count
+void Hyst_Init(Hyst *h, const HystBand *b);
+
+// Forget the output, the next update sets it from its input
+void Hyst_Reset(Hyst *h);
+
+// One comparison
+// Input: v, the value to compare; now, time in the units of dwell
+// Output: 1 if v is taken as above the threshold, 0 if below
+uint8_t Hyst_Update(Hyst *h, uint16_t v, uint32_t now);
+
+#endif
@@ -0,0 +1,147 @@
+// ModeSelect.c
+// Runs on TM4C123, and on a host PC for testing
+// Mode selection from IR statistics, see ModeSelect.h.
+
+#include <stdint.h>
+#include "ModeSelect.h"
+#include "Hyst.h"
+#include "SysTickInts.h"
+
+#if (MODESEL_WINDOW & (MODESEL_WINDOW-1)) != 0
+#error "MODESEL_WINDOW must be a power of 2"
+#endif
+
+// Wall evidence is compared as z^2 scaled by ZSCALE
+#define ZSCALE 16
+static const HystBand WallBand = {MODESEL_Z_ON*MODESEL_Z_ON*ZSCALE, MODESEL_Z_OFF*MODESEL_Z_OFF*ZSCALE, MS_TO_TICKS(MODESEL_DWELL_MS)};
+static const HystBand ObjectBand = {MODESEL_OBJECT_ON, MODESEL_OBJECT_OFF, MS_TO_TICKS(MODESEL_DWELL_MS)};
+
+static uint16_t Window[3][MODESEL_WINDOW];
+static uint32_t Sum[3];
+static uint32_t SumSq[3];           // at most 4095^2*64, fits
+static uint8_t Next;                // oldest sample, overwritten next
+static uint8_t Filled;              // 1 once the window is full
+static uint16_t Latest[3];
+static uint32_t LastSample;
+static uint8_t Sampled;             // LastSample is valid
+static Hyst WallL, WallR, Object;
+static uint8_t Mode;                // current at the last update
+static uint32_t Since;              // stamp of the last mode change
+static uint8_t Want;                // mode the evidence points to
+static uint32_t WantSince;          // since when it has pointed there
+
+void ModeSelect_Init(void){
+  uint8_t s, i;
+  for(s=0; s<3; s++){
+    for(i=0; i<MODESEL_WINDOW; i++){
+      Window[s][i] = 0;
+    }
+    Sum[s] = SumSq[s] = 0;
+  }
+  Next = 0;
+  Filled = 0;
+  Sampled = 0;
+  Mode = Want = MODESEL_NONE;
+  Hyst_Init(&WallL, &WallBand);
+  Hyst_Init(&WallR, &WallBand);
+  Hyst_Init(&Object, &ObjectBand);
+}
+
+uint16_t ModeSelect_Mean(uint8_t sensor){
+  return Sum[sensor]/MODESEL_WINDOW;
+}
+
+uint32_t ModeSelect_Var(uint8_t sensor){
+  uint64_t s = Sum[sensor];
+  return (uint32_t)(((uint64_t)SumSq[sensor]*MODESEL_WINDOW - s*s)/((uint64_t)MODESEL_WINDOW*MODESEL_WINDOW));
+}
+
+uint8_t ModeSelect_Left(void){
+  if (!Filled){
+    return Latest[MODESEL_LEFT] > Latest[MODESEL_RIGHT];
+  }
+  return Sum[MODESEL_LEFT] > Sum[MODESEL_RIGHT];
+}
+
+static void Add(uint8_t sensor, uint16_t v){
+  uint16_t old = Window[sensor][Next];
+  Sum[sensor] += v - old;
+  SumSq[sensor] += (uint32_t)v*v - (uint32_t)old*old;
+  Window[sensor][Next] = v;
+  Latest[sensor] = v;
+}
+
+// z^2*ZSCALE for "side is closer than other", 0 if side does not look like a wall
+static uint16_t Wall_Score(uint8_t side, uint8_t other){
+  uint32_t mean = ModeSelect_Mean(side), var = ModeSelect_Var(side);
+  int32_t d = (int32_t)mean - (int32_t)ModeSelect_Mean(other);
+  uint64_t z2;
+  if ((mean < MODESEL_WALL_SEEN)||(var > MODESEL_WALL_VAR)||(d <= 0)){
+    return 0;
+  }
+  // standard error of the difference: sqrt((var+var_other)/MODESEL_INDEP)
+  z2 = ((uint64_t)d*d*MODESEL_INDEP*ZSCALE)/(var + ModeSelect_Var(other) + MODESEL_VAR_FLOOR);
+  return (z2 > 0xFFFF) ? 0xFFFF : (uint16_t)z2;
+}
+
+// Mode the evidence points to, leaning towards current
+static uint8_t Pick(uint8_t current){
+  uint8_t left = WallL.out, right = WallR.out, object = Object.out;
+  if (current == MODESEL_FOLLOW){
+    if (!object&&(left != right)){
+      return left ? MODESEL_WALL_LEFT : MODESEL_WALL_RIGHT;
+    }
+  }else if (current == MODESEL_WALL_LEFT){
+    if (!left&&right){
+      return MODESEL_WALL_RIGHT;
+    }
+    if (!left&&!right&&object){
+      return MODESEL_FOLLOW;
+    }
+  }else{
+    if (!right&&left){
+      return MODESEL_WALL_LEFT;
+    }
+    if (!left&&!right&&object){
+      return MODESEL_FOLLOW;
+    }
+  }
+  return current;
+}
+
+uint8_t ModeSelect_Update(const SensorFrame *ir, uint8_t current){
+  uint32_t now = ir->stamp;
+  uint8_t want;
+  if (current != Mode){               // switched, by us or by a button
+    Mode = current;
+    Since = now;
+  }
+  if (!Sampled||((now - LastSample) >= MS_TO_TICKS(MODESEL_SAMPLE_MS))){
+    LastSample = now;
+    Sampled = 1;
+    Add(MODESEL_AHEAD, ir->ahead);
+    Add(MODESEL_LEFT, ir->left);
+    Add(MODESEL_RIGHT, ir->right);
+    Next = (Next + 1)&(MODESEL_WINDOW-1);
+    if (Next == 0){
+      Filled = 1;
+    }
+    if (Filled){
+      Hyst_Update(&WallL, Wall_Score(MODESEL_LEFT, MODESEL_RIGHT), now);
+      Hyst_Update(&WallR, Wall_Score(MODESEL_RIGHT, MODESEL_LEFT), now);
+      Hyst_Update(&Object, ModeSelect_Mean(MODESEL_AHEAD), now);
+    }
+  }
+  if (!Filled||(current == MODESEL_NONE)){
+    return current;
+  }
+  want = Pick(current);
+  if (want != Want){
+    Want = want;
+    WantSince = now;
+  }
+  if ((want == current)||((now - WantSince) < MS_TO_TICKS(MODESEL_PERSIST_MS))||((now - Since) < MS_TO_TICKS(MODESEL_HOLD_MS))){
+    return current;
+  }
+  return want;
+}
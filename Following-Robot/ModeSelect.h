@@ -0,0 +1,71 @@
+// ModeSelect.h
+// Runs on TM4C123, and on a host PC for testing
+// Picks object following or the wall side from sliding-window
+// statistics of the three IR readings.
+// Every MODESEL_SAMPLE_MS the readings go into a window of
+// MODESEL_WINDOW samples with running sums, giving the mean and
+// variance of each sensor over the last half second.
+// Evidence for a wall on one side: that side reads at least
+// MODESEL_WALL_SEEN, is steady (variance below MODESEL_WALL_VAR), and
+// its mean is above the other side's by MODESEL_Z_ON standard errors.
+// Evidence for an object: the front mean is at least
+// MODESEL_OBJECT_ON. Each piece of evidence goes through a Hyst.h
+// comparator, so it has to drop well below its threshold, not just
+// under it, to go away, and holds for MODESEL_DWELL_MS once changed.
+// The choice leans towards the current mode: a follower only switches
+// when the evidence for its own mode is gone and the evidence for
+// exactly one other mode is there, has been for MODESEL_PERSIST_MS
+// (longer than a corner pivot), and never within MODESEL_HOLD_MS of
+// the last switch.
+// host/modesel.c replays scripted scenes through it and checks the
+// switch counts and latencies.
+
+#ifndef MODESELECT_H
+#define MODESELECT_H
+#include <stdint.h>
+#include "Sensors.h"
+#include "ADC0SS2.h"
+
+// Modes
+#define MODESEL_NONE       0        // not a follower mode, no opinion
+#define MODESEL_FOLLOW     1
+#define MODESEL_WALL_LEFT  2
+#define MODESEL_WALL_RIGHT 3
+
+// Sensors, for ModeSelect_Mean() and ModeSelect_Var()
+#define MODESEL_AHEAD 0
+#define MODESEL_LEFT  1
+#define MODESEL_RIGHT 2
+
+#define MODESEL_WINDOW    64        // samples, power of 2
+#define MODESEL_SAMPLE_MS 8         // window spans about half a second
+#define MODESEL_INDEP     13        // independent samples in a window: the sensors refresh every ~38 ms
+#define MODESEL_WALL_SEEN (WALL_DIST/2) // side mean for a wall within reach
+#define MODESEL_WALL_VAR  22500     // side variance of a wall, about 150 counts rms
+#define MODESEL_VAR_FLOOR 400       // ADC noise, keeps the z-score finite
+#define MODESEL_Z_ON      3         // left-right difference in standard errors to see a wall
+#define MODESEL_Z_OFF     2         // and to stop seeing it
+#define MODESEL_OBJECT_ON  700      // front mean for an object ahead
+#define MODESEL_OBJECT_OFF 500
+#define MODESEL_DWELL_MS  300
+#define MODESEL_PERSIST_MS 1500
+#define MODESEL_HOLD_MS   2000
+
+// Empty the window and forget the evidence
+void ModeSelect_Init(void);
+
+// Feed one sensor frame and get the mode to be in
+// Input: current, the mode the robot is in now
+// Output: current unless it should switch; MODESEL_NONE for current
+// MODESEL_NONE or while the window is filling up
+uint8_t ModeSelect_Update(const SensorFrame *ir, uint8_t current);
+
+// 1 if the left side is closer on average over the window, falling
+// back to the latest frame while the window is filling up
+uint8_t ModeSelect_Left(void);
+
+// Window mean and variance of one sensor, in ADC counts and counts^2
+uint16_t ModeSelect_Mean(uint8_t sensor);
+uint32_t ModeSelect_Var(uint8_t sensor);
+
+#endif
@@ -0,0 +1,102 @@
+// Motion.c
+// Runs on TM4C123
+// Non-blocking motion primitives closed on the wheel encoders.
+// Progress is the mean absolute travel of the two wheels, so pivots
+// and straight moves are measured the same way and a wrong encoder
+// sign cannot make a primitive run forever. The brake goes on
+// MOTION_COAST_MS of travel at the current speed before the target,
+// since the wheels keep turning for a while once braked.
+
+#include <stdint.h>
+#include "Motion.h"
+#include "Motors.h"
+#include "Odometry.h"
+#include "SysTickInts.h"
+
+static volatile uint8_t Status = MOTION_IDLE;
+static uint32_t Target;                // counts per wheel
+static uint16_t Duty;                  // cruise duty
+static int32_t LeftStart, RightStart;
+static uint32_t Elapsed;               // ticks since the command
+static uint32_t LastTravel;            // travel at the previous tick
+static int32_t Speed;                  // counts per tick, Q8, filtered
+
+static uint32_t Abs(int32_t n){
+  return (n < 0) ? (uint32_t)-n : (uint32_t)n;
+}
+
+// Common start: remember where the wheels are and set the motors going.
+// The ISR may run between these writes; it ignores us until Status is BUSY.
+static void Motion_Start(unsigned long direction, uint32_t target, uint16_t duty){
+  Status = MOTION_IDLE;
+  LeftStart = Odometry_Left_Counts();
+  RightStart = Odometry_Right_Counts();
+  Target = target;
+  Duty = duty;
+  Elapsed = 0;
+  LastTravel = 0;
+  Speed = 0;
+  if (target == 0){
+    Status = MOTION_DONE;
+    return;
+  }
+  DIRECTION = direction;
+  Set_L_Speed(duty);
+  Set_R_Speed(duty);
+  Start_Both_Wheels();
+  Status = MOTION_BUSY;
+}
+
+void Motion_Pivot(int16_t deg, uint16_t duty){
+  if (deg >= 0){
+    Motion_Start(LEFTPIVOT, PIVOT_COUNTS(deg), duty);
+  }else{
+    Motion_Start(RIGHTPIVOT, PIVOT_COUNTS(-deg), duty);
+  }
+}
+
+void Motion_Advance(int16_t mm, uint16_t duty){
+  if (mm >= 0){
+    Motion_Start(FORWARD, ADVANCE_COUNTS(mm), duty);
+  }else{
+    Motion_Start(BACKWARD, ADVANCE_COUNTS(-mm), duty);
+  }
+}
+
+void Motion_Cancel(void){
+  Status = MOTION_IDLE;
+  Stop_Both_Wheels_Mode(STOP_BRAKE);
+}
+
+uint8_t Motion_Status(void){
+  return Status;
+}
+
+void Motion_Tick(void){
+  uint32_t travel, remaining;
+  uint16_t duty;
+  if (Status != MOTION_BUSY){
+    return;
+  }
+  travel = (Abs(Odometry_Left_Counts() - LeftStart) + Abs(Odometry_Right_Counts() - RightStart))/2;
+  Speed += ((int32_t)((travel - LastTravel)<<8) - Speed)/4;
+  LastTravel = travel;
+  // brake early by the distance the wheels still roll once braked
+  if ((int32_t)travel + ((Speed*(int32_t)MS_TO_TICKS(MOTION_COAST_MS))>>8) >= (int32_t)Target){
+    Stop_Both_Wheels_Mode(STOP_BRAKE);
+    Status = MOTION_DONE;
+    return;
+  }
+  if (++Elapsed >= MS_TO_TICKS(MOTION_TIMEOUT_MS)){
+    Stop_Both_Wheels_Mode(STOP_BRAKE);
+    Status = MOTION_TIMEOUT;
+    return;
+  }
+  remaining = Target - travel;
+  duty = Duty;
+  if ((remaining < MOTION_SLOW_COUNTS)&&(Duty > MOTION_MIN_DUTY)){
+    duty = MOTION_MIN_DUTY + ((uint32_t)(Duty - MOTION_MIN_DUTY)*remaining)/MOTION_SLOW_COUNTS;
+  }
+  Set_L_Speed(duty);
+  Set_R_Speed(duty);
+}
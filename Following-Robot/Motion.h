@@ -0,0 +1,48 @@
+// Motion.h
+// Runs on TM4C123
+// Non-blocking motion primitives closed on the wheel encoders.
+// A command starts the motion and returns at once. Motion_Tick(),
+// called from the SysTick ISR after Odometry_Update(), slows the
+// wheels down near the target, brakes on arrival and posts the
+// result, which the behaviour code polls with Motion_Status().
+// While a primitive is MOTION_BUSY nothing else may drive the motors.
+
+#ifndef MOTION_H
+#define MOTION_H
+#include <stdint.h>
+#include "Motors.h"
+#include "Odometry.h"
+
+// Motion_Status() results
+#define MOTION_IDLE    0   // no primitive has been started
+#define MOTION_BUSY    1
+#define MOTION_DONE    2   // target reached
+#define MOTION_TIMEOUT 3   // MOTION_TIMEOUT_MS passed first, e.g. wheel blocked
+
+#define MOTION_TIMEOUT_MS 4000
+#define MOTION_SLOW_COUNTS 120     // start slowing down this many counts before the target
+#define MOTION_MIN_DUTY (PERIOD*25/100) // slowest duty used near the target
+#define MOTION_COAST_MS 30         // wheels stop about this long after the brake, at their speed then
+
+// Encoder counts per wheel for a pivot of deg degrees / a straight move of mm
+#define PIVOT_COUNTS(deg) ((uint32_t)(((int64_t)(deg)*WHEEL_BASE_UM*ENCODER_CPR)/((int64_t)360*WHEEL_DIAMETER_UM)))
+#define ADVANCE_COUNTS(mm) ((uint32_t)(((int64_t)(mm)*1000*ENCODER_CPR*1000000)/((int64_t)ODO_PI_E6*WHEEL_DIAMETER_UM)))
+
+// Pivot on the spot by deg degrees at the given duty
+// deg > 0 turns the way Move_Left_Pivot does, deg < 0 the other way
+void Motion_Pivot(int16_t deg, uint16_t duty);
+
+// Drive straight for mm millimetres at the given duty, mm < 0 backs up
+void Motion_Advance(int16_t mm, uint16_t duty);
+
+// Stop the current primitive with a brake, status becomes MOTION_IDLE
+void Motion_Cancel(void);
+
+// MOTION_IDLE, MOTION_BUSY, MOTION_DONE or MOTION_TIMEOUT
+// DONE and TIMEOUT stay until the next command
+uint8_t Motion_Status(void);
+
+// Motion executor, call from the SysTick ISR after Odometry_Update()
+void Motion_Tick(void);
+
+#endif
@@ -51,10 +51,40 @@
 #include <stdint.h>
 #include "Motors.h"
 #include "tm4c123gh6pm.h"
+#include "SysTickInts.h"
+#include "Params.h"
+#include "Trace.h"
+
+#define TRIM_SEG_WIDTH (PERIOD/TRIM_SEGMENTS)
+
+long StartCritical(void);     // previous I bit, disable interrupts
+void EndCritical(long sr);    // restore I bit to previous value
 
-#define PERIOD 10000				// Total PWM period
 #define PLL_SYSDIV_50MHZ 7
 
+// RCC settings for the PWM clock divider selected by PWM_DIV in Motors.h
+#if PWM_DIV == 1
+#define PWM_RCC_DIV 0
+#elif PWM_DIV == 2
+#define PWM_RCC_DIV (SYSCTL_RCC_USEPWMDIV|SYSCTL_RCC_PWMDIV_2)
+#elif PWM_DIV == 4
+#define PWM_RCC_DIV (SYSCTL_RCC_USEPWMDIV|SYSCTL_RCC_PWMDIV_4)
+#elif PWM_DIV == 8
+#define PWM_RCC_DIV (SYSCTL_RCC_USEPWMDIV|SYSCTL_RCC_PWMDIV_8)
+#elif PWM_DIV == 16
+#define PWM_RCC_DIV (SYSCTL_RCC_USEPWMDIV|SYSCTL_RCC_PWMDIV_16)
+#elif PWM_DIV == 32
+#define PWM_RCC_DIV (SYSCTL_RCC_USEPWMDIV|SYSCTL_RCC_PWMDIV_32)
+#elif PWM_DIV == 64
+#define PWM_RCC_DIV (SYSCTL_RCC_USEPWMDIV|SYSCTL_RCC_PWMDIV_64)
+#else
+#error "PWM_DIV must be 1, 2, 4, 8, 16, 32 or 64"
+#endif
+
+static volatile uint32_t idle_ticks = 0;   // ticks with both PWM outputs off
+static volatile uint8_t asleep = 0;        // 1 when nSLEEP is low on both drivers
+static volatile uint8_t lockout = 0;       // LOCKOUT_xx bits of the checks holding the motors off
+
 uint16_t curr_speed_idx = 0;
 uint16_t speeds[] = {STOP, SPEED_35, SPEED_60, SPEED_80, SPEED_98};
 #define NUM_OF_SPEEDS		5
@@ -71,11 +101,8 @@ void Wheels_PWM_Init(void){
   GPIO_PORTB_AMSEL_R &= ~0x30;          // disable analog functionality on PB6
   GPIO_PORTB_DEN_R |= 0x30;             // enable digital I/O on PB6
   GPIO_PORTB_DR8R_R |= 0x30;    // enable 8 mA drive on PB6,7
-  SYSCTL_RCC_R = 0x00100000 |           // 3) use PWM divider
-    (SYSCTL_RCC_R & (~0x001E0000));   //    configure for /2 divider: PWM clock: 80Mhz/2=40MHz
-  SYSCTL_RCC_R |= SYSCTL_RCC_USEPWMDIV; // 3) use PWM divider
-  SYSCTL_RCC_R &= ~SYSCTL_RCC_PWMDIV_M; //    clear PWM divider field
-  SYSCTL_RCC_R |= SYSCTL_RCC_PWMDIV_2;  //    configure for /2 divider
+  SYSCTL_RCC_R = PWM_RCC_DIV |          // 3) PWM clock = BUS_CLOCK/PWM_DIV
+    (SYSCTL_RCC_R & ~(SYSCTL_RCC_USEPWMDIV|SYSCTL_RCC_PWMDIV_M));
 
 	PWM0_1_CTL_R = 0;                     // 4) re-loading down-counting mode
 	PWM0_1_GENA_R = PWM_1_GENA_ACTCMPAD_ONE|PWM_1_GENA_ACTLOAD_ZERO;   // PB6: low on LOAD, high on CMPA down
@@ -84,24 +111,89 @@ void Wheels_PWM_Init(void){
   PWM0_1_CTL_R |= 0x00000001;           // 7) start PWM0
 }
 
+// Busy-wait for about us microseconds, at roughly 4 bus cycles per iteration
+static void Delay_us(uint32_t us){
+  volatile uint32_t i = us*(BUS_CLOCK/4000000);
+  while(i){ i--; }
+}
+
+void Motors_Wake(void){
+  idle_ticks = 0;                       // cleared first so the tick cannot put us back to sleep
+  if (asleep){
+    MOTOR_SLP = 0x88;
+    asleep = 0;
+    Delay_us(MOTOR_WAKE_US);            // outputs are not valid until t_WAKE has passed
+  }
+}
+
+void Motors_Sleep_Tick(void){
+  if (PWM0_ENABLE_R&0x0000000C){        // a wheel is being driven
+    idle_ticks = 0;
+    return;
+  }
+  if (!asleep){
+    idle_ticks++;
+    if (idle_ticks >= MS_TO_TICKS(MOTOR_SLEEP_MS)){
+      MOTOR_SLP = 0;
+      asleep = 1;
+    }
+  }
+}
+
+void Motors_Lockout(uint8_t source, uint8_t on){
+  long sr = StartCritical();            // read-modify-write shared with ISRs
+  if (on){
+    lockout |= source;
+  }else{
+    lockout &= ~source;
+  }
+  EndCritical(sr);
+}
+
 // Start left wheel
 void Start_L(void) {
-  PWM0_ENABLE_R |= 0x00000004;          // PB6/M0PWM0
+  long sr;
+  if (lockout){
+    return;
+  }
+  Motors_Wake();
+  sr = StartCritical();                 // a lockout ISR or thread may stop the wheels in between
+  if (lockout == 0){
+    PWM0_ENABLE_R |= 0x00000004;        // PB6/M0PWM0
+    TRACE_COMMIT_POINT();
+  }
+  EndCritical(sr);
 }
 
 // Start right wheel
 void Start_R(void) {
-  PWM0_ENABLE_R |= 0x00000008;          // enable PB4/M0PWM2
+  long sr;
+  if (lockout){
+    return;
+  }
+  Motors_Wake();
+  sr = StartCritical();                 // a lockout ISR or thread may stop the wheels in between
+  if (lockout == 0){
+    PWM0_ENABLE_R |= 0x00000008;        // enable PB4/M0PWM2
+    TRACE_COMMIT_POINT();
+  }
+  EndCritical(sr);
 }
 
 // Stop left wheel
 void Stop_L(void) {
+  long sr = StartCritical();            // read-modify-write shared with ISRs and threads
   PWM0_ENABLE_R &= ~0x00000004;          // PB6/M0PWM0
+  TRACE_COMMIT_POINT();
+  EndCritical(sr);
 }
 
 // Stop right wheel
 void Stop_R(void) {
+  long sr = StartCritical();            // read-modify-write shared with ISRs and threads
   PWM0_ENABLE_R &= ~0x00000008;          // enable PB7/M0PWM1
+  TRACE_COMMIT_POINT();
+  EndCritical(sr);
 }
 
 void Start_Both_Wheels(void){
@@ -114,6 +206,45 @@ void Stop_Both_Wheels(void) {
 	Stop_R();
 }
 
+// Disabled PWM outputs are driven low, so EN=0 on both drivers.
+// What the motors do then depends only on nSLEEP.
+void Stop_Both_Wheels_Mode(uint8_t stop_mode){
+	Stop_Both_Wheels();
+	if (stop_mode == STOP_BRAKE){
+		if (!asleep){
+			MOTOR_SLP = 0x88; // keep drivers awake: outputs low, motor shorted
+		}                   // already asleep means already stopped, leave them be
+	}else{
+		MOTOR_SLP = 0;      // drivers asleep: outputs high impedance
+		asleep = 1;
+	}
+}
+
+void Set_Wheels(int16_t left, int16_t right){
+	if (left > 0){
+		L_DIR = 0x04;
+		Set_L_Speed(left);
+		Start_L();
+	}else if (left < 0){
+		L_DIR = 0;
+		Set_L_Speed(-left);
+		Start_L();
+	}else{
+		Stop_L();
+	}
+	if (right > 0){
+		R_DIR = 0x40;
+		Set_R_Speed(right);
+		Start_R();
+	}else if (right < 0){
+		R_DIR = 0;
+		Set_R_Speed(-right);
+		Start_R();
+	}else{
+		Stop_R();
+	}
+}
+
 void Move_Left_Pivot(void){
 	DIRECTION = LEFTPIVOT;
 	Set_R_Speed(SPEED_98);
@@ -198,13 +329,39 @@ void Move_Left_Forward_Follower(void){
 }
 
 
-// Set duty cycle for Left Wheel: PB6
+// Map a requested duty cycle through a wheel's calibration (Params.h)
+// Fixed cost: one segment lookup, one interpolation, one multiply.
+static uint16_t Trim_Duty(const WheelTrim *t, uint16_t duty){
+  uint32_t seg, frac;
+  int32_t corr, out;
+  if (duty <= STOP){
+    return STOP;                        // stopped stays stopped, no deadband kick
+  }
+  seg = duty/TRIM_SEG_WIDTH;
+  if (seg >= TRIM_SEGMENTS){
+    seg = TRIM_SEGMENTS-1;
+  }
+  frac = duty - seg*TRIM_SEG_WIDTH;
+  corr = t->corr[seg] + ((int32_t)(t->corr[seg+1] - t->corr[seg])*(int32_t)frac)/TRIM_SEG_WIDTH;
+  out = t->deadband + (((int32_t)duty + corr)*t->gain)/TRIM_GAIN_ONE;
+  if (out < STOP){
+    out = STOP;
+  }
+  if (out > PERIOD-1){
+    out = PERIOD-1;
+  }
+  return (uint16_t)out;
+}
+
+// Set duty cycle for Left Wheel: PB4
 void Set_L_Speed(uint16_t duty){
-  PWM0_1_CMPA_R = duty - 1;             // 6) count value when output rises
+  PWM0_1_CMPA_R = Trim_Duty(&Params.left, duty) - 1;   // 6) count value when output rises
+  TRACE_COMMIT_POINT();
 }
-// Set duty cycle for Right Wheel: PB7
+// Set duty cycle for Right Wheel: PB5
 void Set_R_Speed(uint16_t duty){
-  PWM0_1_CMPB_R = duty - 1;             // 6) count value when output rises
+  PWM0_1_CMPB_R = Trim_Duty(&Params.right, duty) - 1;  // 6) count value when output rises
+  TRACE_COMMIT_POINT();
 }
 
 // Initialize port E pins PE0-3 for output
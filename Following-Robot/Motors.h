@@ -22,6 +22,7 @@
  */
 // Modified by Min He, September 7, 2021
 #include <stdint.h>
+#include "PLL.h"
 
 /*
  New Pinout
@@ -36,23 +37,73 @@
  SLP PB7
 */
 
+#ifndef DIRECTION // host builds bring their own, see host/pivot.c
 #define DIRECTION (*((volatile unsigned long *)0x40005330))
+#endif
 #define FORWARD 			0xCC	//1100 1100, both wheels move forward
 #define BACKWARD 			0x88	//0100 0100, both wheels move backward
 #define LEFTPIVOT   	0x8C
 #define RIGHTPIVOT  	0xC8 
+#define MOTOR_SLP (*((volatile unsigned long *)0x40005220)) // PB7 and PB3 only: DRV8838 nSLEEP lines
+#define L_DIR (*((volatile unsigned long *)0x40005010))     // PB2 only, 0x04 = forward
+#define R_DIR (*((volatile unsigned long *)0x40005100))     // PB6 only, 0x40 = forward
+
+// Stop policies for Stop_Both_Wheels_Mode()
+// DRV8838 truth table (PH/EN mode): nSLEEP=0 -> outputs high impedance (coast),
+// nSLEEP=1 and EN=0 -> both outputs low (brake, windings shorted through the low-side FETs).
+#define STOP_COAST 0
+#define STOP_BRAKE 1
 
 #define LIGHT (*((volatile unsigned long *)0x40025038)) // onboard RBG LEDs are used to show car status. 
 #define RED 0x02
 #define GREEN 0x08
 #define BLUE 0x04
 
+// PWM profiles for the wheel drivers. Select one with PWM_PROFILE.
+// PERIOD, the PWM clock divider and the SPEED_xx duty cycles below are
+// all derived from BUS_CLOCK (PLL.h) by the preprocessor, so changing
+// SYSDIV2 or the profile needs no other edits.
+//   profile      frequency  PWM clock      counts @16MHz  resolution
+//   LEGACY       800 Hz     BUS_CLOCK/2    10000          13.3 bits (audible)
+//   ULTRASONIC   20 kHz     BUS_CLOCK/1    800            9.6 bits
+//   HIRES        1 kHz      BUS_CLOCK/1    16000          14.0 bits (audible)
+#define PWM_PROFILE_LEGACY     0
+#define PWM_PROFILE_ULTRASONIC 1
+#define PWM_PROFILE_HIRES      2
+
+#ifndef PWM_PROFILE
+#define PWM_PROFILE PWM_PROFILE_ULTRASONIC
+#endif
+
+#if PWM_PROFILE == PWM_PROFILE_LEGACY
+#define PWM_FREQ 800        // Hz
+#define PWM_DIV  2          // PWM clock = BUS_CLOCK/PWM_DIV: 1, 2, 4, 8, 16, 32 or 64
+#elif PWM_PROFILE == PWM_PROFILE_ULTRASONIC
+#define PWM_FREQ 20000
+#define PWM_DIV  1
+#elif PWM_PROFILE == PWM_PROFILE_HIRES
+#define PWM_FREQ 1000
+#define PWM_DIV  1
+#else
+#error "Unknown PWM_PROFILE"
+#endif
+
+#define PWM_CLOCK (BUS_CLOCK/PWM_DIV)
+#define PERIOD (PWM_CLOCK/PWM_FREQ)     // Total PWM period in PWM clock counts
+
+#if PERIOD > 32767
+#error "PWM period must fit a signed 16-bit duty (Set_Wheels), use a larger PWM_DIV"
+#endif
+#if PERIOD < 100
+#error "PWM period gives less than 1% duty resolution, use a smaller PWM_DIV"
+#endif
+
 // duty cycles for different speeds
 #define STOP 1
-#define SPEED_35 3500
-#define SPEED_60 6000
-#define SPEED_80 8000
-#define SPEED_98 9800
+#define SPEED_35 (PERIOD*35/100)
+#define SPEED_60 (PERIOD*60/100)
+#define SPEED_80 (PERIOD*80/100)
+#define SPEED_98 (PERIOD*98/100)
 
 // Wheel PWM connections: on PB6/M0PWM0:Left wheel, PB7/M0PWM0:Right wheel
 void Wheels_PWM_Init(void);
@@ -73,6 +124,35 @@ void Start_Both_Wheels(void);
 
 void Stop_Both_Wheels(void);
 
+// Driver power management. The DRV8838s are put to sleep once both PWM
+// outputs have been off for MOTOR_SLEEP_MS, and woken again by Start_L or
+// Start_R, which wait MOTOR_WAKE_US (datasheet t_WAKE) before driving.
+#define MOTOR_SLEEP_MS 2000
+#define MOTOR_WAKE_US  30
+
+// Wake the drivers if they are asleep and restart the idle timer.
+void Motors_Wake(void);
+
+// Idle timer for the drivers. Call once per SysTick interrupt.
+void Motors_Sleep_Tick(void);
+
+// Lock the motors out (on=1) or release them (on=0) on behalf of one
+// safety check. While any check holds a lockout Start_L and Start_R do
+// nothing, so no motion command can restart a wheel that was cut.
+#define LOCKOUT_STALL 0x01
+#define LOCKOUT_ESTOP 0x02
+void Motors_Lockout(uint8_t source, uint8_t on);
+
+// Stop both wheels using the given policy: STOP_COAST or STOP_BRAKE.
+// Brake holds the drivers awake with EN low so the back EMF is shorted
+// and the robot stops in a much shorter distance. Coast puts the drivers
+// to sleep so the wheels turn freely. The next Move_xx call re-enables them.
+void Stop_Both_Wheels_Mode(uint8_t stop_mode);
+
+// Drive each wheel at a signed duty cycle: > 0 forward, < 0 backward, 0 stop
+// |left| and |right| are duty cycles like SPEED_xx, up to PERIOD
+void Set_Wheels(int16_t left, int16_t right);
+
 void Move_Forward(void);
 void Move_Backward(void);
 void Move_Left_Pivot(void);
@@ -91,10 +171,12 @@ void Move_Right_Forward_Follower(void);
 void Move_Left_Forward_Follower(void);
 
 
-// Change duty cycle of left wheel: PB6
+// Change duty cycle of left wheel: PB4
+// duty is passed through the left wheel trim in Params before it is applied
 void Set_L_Speed(uint16_t duty);
 
-// change duty cycle of right wheel: PB7
+// change duty cycle of right wheel: PB5
+// duty is passed through the right wheel trim in Params before it is applied
 void Set_R_Speed(uint16_t duty);
 
 // Initialize port E pins PE0-3 for output
@@ -0,0 +1,137 @@
+// OS.c
+// Runs on TM4C123
+// Minimal preemptive priority kernel, see OS.h.
+
+#include <stdint.h>
+#include "OS.h"
+#include "CycleCount.h"
+#include "tm4c123gh6pm.h"
+
+long StartCritical(void);     // previous I bit, disable interrupts
+void EndCritical(long sr);    // restore I bit to previous value
+void OS_Launch(TCB *first);   // osasm.s
+
+TCB *RunPt;                   // running thread, used by osasm.s
+TCB *NextPt;                  // thread PendSV switches to, used by osasm.s
+uint32_t OS_SwitchCycles;     // written by PendSV_Handler in osasm.s
+uint32_t OS_WakeCycles;
+
+static TCB Threads[OS_MAX_THREADS];   // indexed by priority
+static uint32_t Stacks[OS_MAX_THREADS][OS_STACK_WORDS] __attribute__((aligned(8)));
+static volatile uint32_t ReadyMask;   // bit p set: thread at priority p is ready
+static volatile uint8_t Started;
+static volatile uint32_t PendStamp;   // CYCLES() when PendSV was last pended
+
+// A thread function returned: park it for the debugger
+static void OS_ThreadExit(void){
+  while(1){};
+}
+
+// Lowest set bit of ReadyMask is the highest priority ready thread.
+// The idle thread keeps the mask non-zero.
+static TCB *OS_Highest(void){
+#if defined(__GNUC__)               // armclang and gcc: RBIT + CLZ on the M4
+  return &Threads[__builtin_ctz(ReadyMask)];
+#elif defined(__CC_ARM)             // armcc 5
+  return &Threads[__clz(__rbit(ReadyMask))];
+#else
+  uint8_t i = 0;
+  while(((ReadyMask>>i)&1) == 0){
+    i++;
+  }
+  return &Threads[i];
+#endif
+}
+
+// Pick the highest priority ready thread and pend PendSV if it is not
+// the one running. Interrupts must be disabled.
+static void OS_Schedule(void){
+  NextPt = OS_Highest();
+  if (NextPt != RunPt){
+    PendStamp = CYCLES();
+    NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+  }
+}
+
+void OS_Init(void){
+  uint8_t i;
+  for(i=0; i<OS_MAX_THREADS; i++){
+    Threads[i].used = 0;
+  }
+  ReadyMask = 0;
+  Started = 0;
+  OS_SwitchCycles = 0;
+  OS_WakeCycles = 0;
+  CycleCount_Init();
+  NVIC_SYS_PRI3_R = (NVIC_SYS_PRI3_R&~NVIC_SYS_PRI3_PENDSV_M)|0x00E00000; // PendSV priority 7, lowest
+}
+
+int OS_AddThread(void (*task)(void), uint8_t priority){
+  uint32_t *sp;
+  uint32_t i;
+  if ((priority >= OS_MAX_THREADS)||Threads[priority].used){
+    return 0;
+  }
+  for(i=0; i<OS_STACK_WORDS; i++){
+    Stacks[priority][i] = OS_STACK_FILL;
+  }
+  sp = &Stacks[priority][OS_STACK_WORDS];
+  *(--sp) = 0x01000000;               // xPSR, Thumb bit
+  *(--sp) = (uint32_t)task;           // PC
+  *(--sp) = (uint32_t)OS_ThreadExit;  // LR
+  for(i=0; i<5; i++){                 // R12, R3, R2, R1, R0
+    *(--sp) = 0;
+  }
+  for(i=0; i<8; i++){                 // R11..R4, restored by PendSV
+    *(--sp) = 0;
+  }
+  Threads[priority].sp = sp;
+  Threads[priority].sleep = 0;
+  Threads[priority].priority = priority;
+  Threads[priority].used = 1;
+  ReadyMask |= 1u<<priority;
+  return 1;
+}
+
+void OS_Start(void){
+  StartCritical();                    // OS_Launch re-enables interrupts
+  RunPt = NextPt = OS_Highest();
+  Started = 1;
+  OS_Launch(RunPt);
+}
+
+void OS_Sleep(uint32_t ticks){
+  uint32_t wake;
+  long sr = StartCritical();
+  RunPt->sleep = ticks ? ticks : 1;
+  ReadyMask &= ~(1u<<RunPt->priority);
+  OS_Schedule();
+  EndCritical(sr);                    // PendSV runs here
+  wake = CYCLES() - PendStamp;        // back from the switch that woke this thread
+  if (wake > OS_WakeCycles){
+    OS_WakeCycles = wake;
+  }
+}
+
+void OS_Tick(void){
+  uint8_t i;
+  if (!Started){
+    return;
+  }
+  for(i=0; i<OS_MAX_THREADS; i++){
+    if (Threads[i].sleep){
+      if (--Threads[i].sleep == 0){
+        ReadyMask |= 1u<<i;
+      }
+    }
+  }
+  OS_Schedule();
+}
+
+uint32_t OS_StackFree(uint8_t priority){
+  uint32_t n = 0;
+  while((n < OS_STACK_WORDS)&&(Stacks[priority][n] == OS_STACK_FILL)){
+    n++;
+  }
+  return n;
+}
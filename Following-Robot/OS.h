@@ -0,0 +1,62 @@
+// OS.h
+// Runs on TM4C123
+// Minimal preemptive priority kernel.
+// Threads have fixed, distinct priorities (0 is highest) and static
+// stacks. The ready list is a bit mask indexed by priority, so picking
+// the next thread is one count-trailing-zeros whatever the load.
+// SysTick_Handler calls OS_Tick() once per tick to wake sleeping
+// threads; a switch is requested by pending PendSV, which runs at the
+// lowest priority after all other ISRs and saves/restores R4-R11 on the
+// thread stacks (osasm.s). Threads run on PSP, handlers on MSP, so
+// thread stacks need no room for interrupt frames beyond one level.
+// The FPU is left disabled by startup.s, so there is no FP context.
+
+#ifndef OS_H
+#define OS_H
+#include <stdint.h>
+
+#define OS_MAX_THREADS 4            // one per priority level, 0..OS_MAX_THREADS-1
+#define OS_STACK_WORDS 256          // 1 KB per thread
+#define OS_STACK_FILL  0xDEADBEEF   // marks never-used stack for watermarks
+
+typedef struct tcb {
+  uint32_t *sp;                     // saved stack pointer, must be first (osasm.s)
+  uint32_t sleep;                   // ticks left to sleep, 0 when ready
+  uint8_t priority;
+  uint8_t used;
+} TCB;
+
+// Set up the kernel: PendSV priority, cycle counter
+void OS_Init(void);
+
+// Create a thread. Call before OS_Launch.
+// task must never return. priority must be unused and < OS_MAX_THREADS.
+// Output: 1 if created, 0 on a bad or taken priority
+int OS_AddThread(void (*task)(void), uint8_t priority);
+
+// Start the highest priority thread. Does not return.
+// SysTick must already be running.
+void OS_Start(void);
+
+// Block the calling thread for ticks SysTick periods (at least 1)
+void OS_Sleep(uint32_t ticks);
+
+// Wake sleeping threads and preempt if needed. Call from SysTick_Handler.
+void OS_Tick(void);
+
+// Unused stack words of the thread at priority, never touched since
+// OS_AddThread. 0 means the stack has overflowed or is about to.
+uint32_t OS_StackFree(uint8_t priority);
+
+// Worst PendSV context switch time seen, in core clock cycles, between
+// the two CYCCNT reads in PendSV_Handler. 37 cycles from the listing.
+extern uint32_t OS_SwitchCycles;
+
+// Worst time seen from OS_Tick() or OS_Sleep() pending PendSV to a
+// thread running again inside OS_Sleep(), in core clock cycles. This
+// is the whole switch as a thread sees it: the rest of the ISR that
+// pended it, exception entry and return, and PendSV_Handler. About 70
+// cycles from the listing when nothing else is pending.
+extern uint32_t OS_WakeCycles;
+
+#endif
@@ -0,0 +1,79 @@
+// Odometry.c
+// Runs on TM4C123
+// Wheel encoder odometry for the Romi chassis, see Odometry.h.
+
+#include <stdint.h>
+#include "Odometry.h"
+#include "tm4c123gh6pm.h"
+
+long StartCritical(void);     // previous I bit, disable interrupts
+void EndCritical(long sr);    // restore I bit to previous value
+
+static Pose Current;
+static uint32_t LeftPrev, RightPrev;       // QEI positions at the last update
+static int32_t LeftCounts, RightCounts;
+
+// Initialize QEI0 and QEI1 and zero the pose
+void Odometry_Init(void){
+  SYSCTL_RCGCQEI_R |= 0x03;                // 1) activate QEI0 and QEI1
+  SYSCTL_RCGCGPIO_R |= 0x0C;               // 2) activate ports C and D
+  while((SYSCTL_RCGCGPIO_R&0x0C) != 0x0C){};
+  GPIO_PORTD_LOCK_R = GPIO_LOCK_KEY;       // PD7 is locked (NMI)
+  GPIO_PORTD_CR_R |= 0x80;
+  GPIO_PORTD_DIR_R &= ~0xC0;               // PD6, PD7 in
+  GPIO_PORTD_AFSEL_R |= 0xC0;
+  GPIO_PORTD_DEN_R |= 0xC0;
+  GPIO_PORTD_AMSEL_R &= ~0xC0;
+  GPIO_PORTD_PCTL_R = (GPIO_PORTD_PCTL_R&0x00FFFFFF)|0x66000000; // PhA0, PhB0
+  GPIO_PORTC_DIR_R &= ~0x60;               // PC5, PC6 in
+  GPIO_PORTC_AFSEL_R |= 0x60;
+  GPIO_PORTC_DEN_R |= 0x60;
+  GPIO_PORTC_AMSEL_R &= ~0x60;
+  GPIO_PORTC_PCTL_R = (GPIO_PORTC_PCTL_R&0xF00FFFFF)|0x06600000; // PhA1, PhB1
+  QEI0_CTL_R = 0;                          // 3) disable while configuring
+  QEI1_CTL_R = 0;
+  QEI0_MAXPOS_R = 0xFFFFFFFF;              //    free-running, wraps modulo 2^32
+  QEI1_MAXPOS_R = 0xFFFFFFFF;
+  QEI0_POS_R = 0;
+  QEI1_POS_R = 0;
+  QEI0_CTL_R = QEI_CTL_CAPMODE|QEI_CTL_ENABLE;              // 4) count all 4 edges
+  QEI1_CTL_R = QEI_CTL_CAPMODE|QEI_CTL_SWAP|QEI_CTL_ENABLE; //    right motor is mirrored
+  LeftPrev = RightPrev = 0;
+  LeftCounts = RightCounts = 0;
+  Odometry_Reset();
+}
+
+// Integrate encoder counts since the last call into the pose
+void Odometry_Update(void){
+  uint32_t left = QEI0_POS_R;
+  uint32_t right = QEI1_POS_R;
+  int32_t dl = (int32_t)(left - LeftPrev); // modulo 2^32 difference
+  int32_t dr = (int32_t)(right - RightPrev);
+  LeftPrev = left;
+  RightPrev = right;
+  LeftCounts += dl;
+  RightCounts += dr;
+  Pose_Step(&Current, dl, dr);
+}
+
+void Odometry_Get(Pose *pose){
+  long sr = StartCritical();
+  *pose = Current;
+  EndCritical(sr);
+}
+
+void Odometry_Reset(void){
+  long sr = StartCritical();
+  Current.x = 0;
+  Current.y = 0;
+  Current.theta = 0;
+  EndCritical(sr);
+}
+
+int32_t Odometry_Left_Counts(void){
+  return LeftCounts;
+}
+
+int32_t Odometry_Right_Counts(void){
+  return RightCounts;
+}
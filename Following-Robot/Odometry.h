@@ -0,0 +1,33 @@
+// Odometry.h
+// Runs on TM4C123
+// Wheel encoder odometry for the Romi chassis.
+// Encoders are read by the two hardware quadrature decoders:
+//  Left encoder:  PD6/PhA0, PD7/PhB0 (QEI0)
+//  Right encoder: PC5/PhA1, PC6/PhB1 (QEI1)
+// Odometry_Update() reads the count changes and integrates them into a
+// pose with Pose_Step(). It is called from the SysTick ISR and always
+// takes the same path, so its cost is bounded.
+
+#ifndef ODOMETRY_H
+#define ODOMETRY_H
+#include <stdint.h>
+#include "Pose.h"
+
+// Initialize QEI0 and QEI1 and zero the pose
+void Odometry_Init(void);
+
+// Integrate encoder counts since the last call into the pose
+// Call from the SysTick ISR
+void Odometry_Update(void);
+
+// Copy the pose with interrupts masked so x, y and theta match
+void Odometry_Get(Pose *pose);
+
+// Set the pose to zero, the current position becomes the origin
+void Odometry_Reset(void);
+
+// Total counts since Odometry_Init, forward positive
+int32_t Odometry_Left_Counts(void);
+int32_t Odometry_Right_Counts(void);
+
+#endif
@@ -25,6 +25,7 @@
 // the PLL to the desired frequency.
 #define SYSDIV2 24
 // bus frequency is 400MHz/(SYSDIV2+1) = 400MHz/(24+1) = 16 MHz
+#define BUS_CLOCK (400000000/(SYSDIV2+1))   // in Hz, used to derive timing constants at compile time
 
 // configure the system to get its clock from the PLL
 void PLL_Init(void);
@@ -0,0 +1,46 @@
+// Params.c
+// Runs on TM4C123
+// Robot-specific parameters kept in EEPROM block 0.
+
+#include <stdint.h>
+#include "Params.h"
+#include "EEPROM.h"
+#include "Motors.h"
+
+#define PARAMS_WORDS ((sizeof(RobotParams)+3)/4)
+
+RobotParams Params;
+
+static void Trim_Default(WheelTrim *t){
+  uint8_t i;
+  t->deadband = 0;
+  t->gain = TRIM_GAIN_ONE;
+  for(i=0; i<=TRIM_SEGMENTS; i++){
+    t->corr[i] = 0;
+  }
+  t->spare = 0;
+}
+
+void Params_Default(void){
+  Params.magic = PARAMS_MAGIC;
+  Params.version = PARAMS_VERSION;
+  Params.period = PERIOD;
+  Trim_Default(&Params.left);
+  Trim_Default(&Params.right);
+}
+
+int Params_Load(void){
+  if(EEPROM_Init()){
+    EEPROM_Read(PARAMS_BLOCK, 0, (uint32_t *)&Params, PARAMS_WORDS);
+    if((Params.magic == PARAMS_MAGIC)&&(Params.version == PARAMS_VERSION)
+      &&(Params.period == PERIOD)){
+      return 1;
+    }
+  }
+  Params_Default();
+  return 0;
+}
+
+int Params_Save(void){
+  return EEPROM_Write(PARAMS_BLOCK, 0, (const uint32_t *)&Params, PARAMS_WORDS);
+}
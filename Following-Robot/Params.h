@@ -0,0 +1,50 @@
+// Params.h
+// Runs on TM4C123
+// Robot-specific parameters kept in EEPROM block 0.
+// Params_Load() falls back to defaults when the EEPROM holds no valid
+// copy, or one written for a different PWM PERIOD or layout version.
+
+#ifndef PARAMS_H
+#define PARAMS_H
+#include <stdint.h>
+
+#define PARAMS_MAGIC   0x524F4D49   // "ROMI"
+#define PARAMS_VERSION 1            // bump whenever RobotParams changes
+#define PARAMS_BLOCK   0            // first EEPROM block used
+
+// Per-wheel duty map, see Trim_Duty() in Motors.c:
+//   out = deadband + (duty + corr(duty))*gain/4096
+// corr() is linear between TRIM_SEGMENTS+1 equally spaced points
+// from 0 to PERIOD. All values are in PWM counts.
+#define TRIM_SEGMENTS 8
+#define TRIM_GAIN_ONE 4096          // gain is Q12
+
+typedef struct {
+  uint16_t deadband;                // counts needed before the wheel turns
+  uint16_t gain;                    // Q12 scale
+  int16_t corr[TRIM_SEGMENTS+1];    // correction at PERIOD*i/TRIM_SEGMENTS
+  int16_t spare;
+} WheelTrim;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t period;                  // PERIOD the trim tables were measured with
+  WheelTrim left;
+  WheelTrim right;
+} RobotParams;
+
+extern RobotParams Params;
+
+// Identity trim for both wheels
+void Params_Default(void);
+
+// Read Params from EEPROM, or use defaults if the stored copy is not valid
+// Output: 1 if loaded from EEPROM, 0 if defaults are in use
+int Params_Load(void);
+
+// Write Params to EEPROM
+// Output: 1 on success
+int Params_Save(void);
+
+#endif
@@ -0,0 +1,49 @@
+// Pid.c
+// Runs on TM4C123, and on a host PC for testing
+// Fixed-point PID controller, see Pid.h.
+
+#include <stdint.h>
+#include "Pid.h"
+
+void Pid_Reset(Pid *pid){
+  pid->integral = 0;
+  pid->dfilt = 0;
+  pid->last = 0;
+  pid->primed = 0;
+}
+
+int32_t Pid_Update(Pid *pid, int32_t setpoint, int32_t measurement){
+  const PidGains *g = pid->g;
+  int32_t error = setpoint - measurement;
+  int32_t integral, out;
+  int64_t sum;
+  if (!pid->primed){                // no history: no derivative on the first step
+    pid->last = measurement;
+    pid->primed = 1;
+  }
+  pid->dfilt += ((((measurement - pid->last)<<8) - pid->dfilt)*(int32_t)g->d_alpha)/256;
+  pid->last = measurement;
+
+  integral = pid->integral + g->ki*error;
+  if (integral > g->out_max*PID_ONE){
+    integral = g->out_max*PID_ONE;
+  }
+  if (integral < g->out_min*PID_ONE){
+    integral = g->out_min*PID_ONE;
+  }
+  sum = (int64_t)g->kp*error + integral - ((int64_t)g->kd*pid->dfilt)/256;
+  out = (int32_t)(sum/PID_ONE);
+  if (out > g->out_max){
+    out = g->out_max;
+    if (error > 0){
+      integral = pid->integral;     // saturated high: do not wind up further
+    }
+  }else if (out < g->out_min){
+    out = g->out_min;
+    if (error < 0){
+      integral = pid->integral;
+    }
+  }
+  pid->integral = integral;
+  return out;
+}
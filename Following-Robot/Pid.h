@@ -0,0 +1,41 @@
+// Pid.h
+// Runs on TM4C123, and on a host PC for testing
+// Fixed-point PID controller, one call per control period.
+// Gains are Q12 and per step, so they depend on the call rate.
+// The derivative acts on the measurement, not the error, so setpoint
+// changes do not kick the output, and is low-pass filtered.
+// Anti-windup: the integral is clamped to the output range and stops
+// growing while the output is saturated in the direction of the error.
+
+#ifndef PID_H
+#define PID_H
+#include <stdint.h>
+
+#define PID_ONE 4096                // 1.0 in Q12
+
+typedef struct {
+  int32_t kp, ki, kd;               // Q12, per step
+  uint16_t d_alpha;                 // derivative filter, Q8 weight of the newest
+                                    // difference: 256 = unfiltered
+  int32_t out_min, out_max;
+} PidGains;
+
+// Bind the gains with a static initializer, e.g.
+// static Pid Range = {&RangeGains}; the rest starts cleared.
+typedef struct {
+  const PidGains *g;
+  int32_t integral;                 // Q12 sum of ki*error
+  int32_t dfilt;                    // Q8 filtered measurement change per step
+  int32_t last;                     // previous measurement
+  uint8_t primed;                   // last is valid
+} Pid;
+
+// Clear integral and derivative history, e.g. after the plant was
+// driven by something else
+void Pid_Reset(Pid *pid);
+
+// One control step
+// Output: command in out_min..out_max
+int32_t Pid_Update(Pid *pid, int32_t setpoint, int32_t measurement);
+
+#endif
@@ -0,0 +1,45 @@
+// Pose.h
+// Runs on TM4C123, and on a host PC for testing
+// Dead-reckoning arithmetic for the Romi chassis, kept apart from the
+// encoder hardware in Odometry.c so it can be checked on a host
+// (host/odom.c).
+// Differential drive, midpoint integration:
+//   ds = (dl + dr)/2, dtheta = (dr - dl)/wheelbase
+//   x += ds*cos(theta + dtheta/2), y += ds*sin(theta + dtheta/2)
+// in fixed point with a sine table. Every step takes the same path, so
+// its cost is bounded.
+
+#ifndef POSE_H
+#define POSE_H
+#include <stdint.h>
+
+// Romi chassis geometry, robot-specific
+#define ENCODER_CPR       1440     // counts per wheel turn: 12 counts per motor turn x 120:1 gearbox
+#define WHEEL_DIAMETER_UM 70000    // 70 mm wheels
+#define WHEEL_BASE_UM     141000   // distance between the wheel contact points
+
+#define ODO_PI_E6         3141593
+// wheel travel per count, Q16 mm
+#define ODO_MM_Q16_PER_COUNT ((int32_t)((ODO_PI_E6*(int64_t)WHEEL_DIAMETER_UM*65536)/((int64_t)1000000*1000*ENCODER_CPR)))
+// heading change per count of wheel difference, 2^32 = one turn (pi cancels out)
+#define ODO_ANGLE_PER_COUNT  ((int32_t)(((int64_t)WHEEL_DIAMETER_UM<<32)/((int64_t)2*ENCODER_CPR*WHEEL_BASE_UM)))
+
+// Angle helpers for the 2^32 = one turn heading format
+#define DEG_TO_ANGLE(deg) ((uint32_t)((int32_t)(deg)*(int32_t)11930465)) // 2^32/360, deg in -179..179
+#define ANGLE_TO_DEG(a)   ((int32_t)(((int64_t)(int32_t)(a)*360 + 0x80000000LL)>>32)) // rounded, -180..180
+
+typedef struct {
+  int32_t x;        // Q16 mm, forward at start is +x
+  int32_t y;        // Q16 mm, left at start is +y
+  uint32_t theta;   // heading, 2^32 = one turn, counter-clockwise positive
+} Pose;
+
+// Add the wheel travel of one step, in encoder counts, to *pose
+void Pose_Step(Pose *pose, int32_t dl, int32_t dr);
+
+// Q15 sine and cosine of a 2^32 = one turn angle, linear interpolation
+// between 256 table entries, error below 0.0002
+int16_t Pose_Sin(uint32_t angle);
+int16_t Pose_Cos(uint32_t angle);
+
+#endif
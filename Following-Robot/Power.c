@@ -0,0 +1,78 @@
+// Power.c
+// Runs on TM4C123
+// Sleep and deep sleep from the idle thread, see Power.h.
+
+#include <stdint.h>
+#include "Power.h"
+#include "SysTickInts.h"
+#include "tm4c123gh6pm.h"
+
+long StartCritical(void);     // previous I bit, disable interrupts
+void EndCritical(long sr);    // restore I bit to previous value
+void WaitForInterrupt(void);  // low power mode
+
+static volatile uint8_t DeepRequest;
+static uint32_t DeepSleeps;
+static uint32_t IdleCycles;   // in WFI since WindowStart
+static uint32_t WindowStart;
+
+// Interrupts are disabled: the switch interrupt stays pending and
+// wakes the core, and runs once interrupts are enabled again.
+static void Power_Deep(void){
+  NVIC_ST_CTRL_R &= ~NVIC_ST_CTRL_ENABLE;       // no ticks: threads stay asleep
+  SYSCTL_DCGCGPIO_R = SYSCTL_DCGCGPIO_D5;        // port F only: switches and LED
+  SYSCTL_DCGCADC_R = 0;
+  SYSCTL_DCGCPWM_R = 0;                          // outputs already low, drivers asleep
+  SYSCTL_DCGCQEI_R = 0;
+  SYSCTL_DCGCTIMER_R = SYSCTL_DCGCTIMER_D0;      // Timer0A: switch debounce still runs
+  SYSCTL_DCGCEEPROM_R = 0;
+  SYSCTL_DSLPCLKCFG_R = SYSCTL_DSLPCLKCFG_O_IO;  // PIOSC, divide by 1
+  SYSCTL_RCC_R |= SYSCTL_RCC_ACG;                // use DCGC while in deep sleep
+  NVIC_SYS_CTRL_R |= NVIC_SYS_CTRL_SLEEPDEEP;
+  WaitForInterrupt();
+  NVIC_SYS_CTRL_R &= ~NVIC_SYS_CTRL_SLEEPDEEP;   // run-mode clock is restored by hardware
+  SYSCTL_RCC_R &= ~SYSCTL_RCC_ACG;               // plain WFI keeps run-mode clocks
+  NVIC_ST_CTRL_R |= NVIC_ST_CTRL_ENABLE;
+  DeepRequest = 0;
+  DeepSleeps++;
+}
+
+void Power_Idle(void){
+  uint32_t start;
+  long sr = StartCritical();  // WFI still wakes on a pending interrupt
+  if (DeepRequest){
+    Power_Deep();
+  }else{
+    start = SysTick_Cycles();
+    WaitForInterrupt();
+    IdleCycles += SysTick_Cycles() - start;
+  }
+  EndCritical(sr);
+}
+
+void Power_Deep_Request(void){
+  DeepRequest = 1;
+}
+
+void Power_Deep_Cancel(void){
+  DeepRequest = 0;
+}
+
+uint32_t Power_Measure_Idle(void){
+  uint32_t idle, now, window;
+  long sr = StartCritical();
+  now = SysTick_Cycles();
+  window = now - WindowStart;
+  idle = IdleCycles;
+  IdleCycles = 0;
+  WindowStart = now;
+  EndCritical(sr);
+  if (window == 0){
+    return 0;
+  }
+  return (uint32_t)(((uint64_t)idle*1000)/window);
+}
+
+uint32_t Power_Deep_Count(void){
+  return DeepSleeps;
+}
@@ -0,0 +1,42 @@
+// Power.h
+// Runs on TM4C123
+// Power state manager, called from the kernel idle thread.
+// Run:        threads and ISRs are working.
+// Sleep:      nothing is ready. Power_Idle() stops the core clock with
+//             WFI until the next interrupt, normally the next SysTick.
+//             Peripherals keep their run-mode clocks, so control timing
+//             is unchanged.
+// Deep sleep: the robot is inactive and has asked for it with
+//             Power_Deep_Request(). SysTick is stopped, every peripheral
+//             clock but port F and the debounce timer is gated, the
+//             core runs from the PIOSC, and only a switch on PF0/PF4
+//             wakes it up. GPIOPortF_Handler runs first, then the
+//             run-mode clocks and SysTick come back and the request is
+//             dropped.
+// Wake-up from deep sleep costs the PIOSC start and the PLL relock,
+// well under a millisecond and far below the switch bounce time.
+// It has not been measured on the robot.
+
+#ifndef POWER_H
+#define POWER_H
+#include <stdint.h>
+
+// Sleep until the next interrupt, or deep sleep if requested.
+// Call in a loop from the lowest priority thread.
+void Power_Idle(void);
+
+// Enter deep sleep the next time the CPU goes idle.
+// Call only with the motors stopped; ticks stop while asleep.
+void Power_Deep_Request(void);
+
+// Drop a pending deep sleep request, e.g. a switch was pressed
+void Power_Deep_Cancel(void);
+
+// Share of time spent in WFI since the last call, in 1/1000.
+// Deep sleep is not counted: there is no time base while in it.
+uint32_t Power_Measure_Idle(void);
+
+// Number of deep sleeps entered since reset
+uint32_t Power_Deep_Count(void);
+
+#endif
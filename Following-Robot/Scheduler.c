@@ -0,0 +1,115 @@
+// Scheduler.c
+// Runs on TM4C123, and on a host PC for testing
+// Rate-monotonic cooperative scheduler with a compile-time task table.
+// The tick ISR only writes Released[] and ReleaseTime[]; the main loop
+// only writes Started[]. A task is pending while Released != Started,
+// so no interrupts ever need to be disabled.
+
+#include <stdint.h>
+#include "Scheduler.h"
+
+static const Task *Table;
+static uint8_t Count;
+static uint32_t (*Cycles)(void);
+static uint32_t WindowStart;
+
+static uint16_t Countdown[SCHED_MAX_TASKS];              // ISR only
+static volatile uint32_t Released[SCHED_MAX_TASKS];      // ISR only
+static volatile uint32_t ReleaseTime[SCHED_MAX_TASKS];   // ISR only
+static uint32_t Started[SCHED_MAX_TASKS];                // main only
+static TaskStats Stats[SCHED_MAX_TASKS];                 // main only
+
+void Scheduler_Init(const Task *table, uint8_t count, uint32_t (*cycles)(void)){
+  uint8_t i;
+  if (count > SCHED_MAX_TASKS){
+    count = SCHED_MAX_TASKS;
+  }
+  Count = 0;                      // the ISR sees no tasks while we set up
+  Table = table;
+  Cycles = cycles;
+  for(i=0; i<count; i++){
+    Countdown[i] = table[i].offset + 1;
+    Released[i] = Started[i] = 0;
+    Stats[i].runs = Stats[i].skipped = 0;
+    Stats[i].busy = Stats[i].load = Stats[i].wcet = Stats[i].max_jitter = 0;
+  }
+  WindowStart = Cycles();
+  Count = count;
+}
+
+void Scheduler_Tick(void){
+  uint8_t i, stamped = 0;
+  uint32_t now = 0;
+  for(i=0; i<Count; i++){
+    if (--Countdown[i] == 0){
+      Countdown[i] = Table[i].period;
+      if (!stamped){
+        now = Cycles();           // one time stamp for every task released this tick
+        stamped = 1;
+      }
+      ReleaseTime[i] = now;
+      Released[i]++;
+    }
+  }
+}
+
+uint32_t Scheduler_Run(void){
+  uint8_t i;
+  uint32_t runs = 0, released, start, elapsed, jitter;
+  i = 0;
+  while(i < Count){
+    released = Released[i];
+    if (released == Started[i]){
+      i++;                        // nothing pending here, try the next priority
+      continue;
+    }
+    Stats[i].skipped += released - Started[i] - 1;
+    Started[i] = released;
+    start = Cycles();
+    jitter = start - ReleaseTime[i];
+    Table[i].run();
+    elapsed = Cycles() - start;
+    Stats[i].runs++;
+    Stats[i].busy += elapsed;
+    if (elapsed > Stats[i].wcet){
+      Stats[i].wcet = elapsed;
+    }
+    if (jitter > Stats[i].max_jitter){
+      Stats[i].max_jitter = jitter;
+    }
+    runs++;
+    i = 0;                        // a faster task may have been released meanwhile
+  }
+  return runs;
+}
+
+uint8_t Scheduler_Ready(void){
+  uint8_t i;
+  for(i=0; i<Count; i++){
+    if (Released[i] != Started[i]){
+      return 1;
+    }
+  }
+  return 0;
+}
+
+const TaskStats *Scheduler_Stats(uint8_t i){
+  return &Stats[i];
+}
+
+uint32_t Scheduler_Measure_Load(void){
+  uint8_t i;
+  uint32_t now = Cycles();
+  uint32_t window = now - WindowStart;
+  uint32_t total = 0;
+  if (window == 0){
+    return 0;
+  }
+  for(i=0; i<Count; i++){
+    Stats[i].load = (uint32_t)(((uint64_t)Stats[i].busy*1000)/window);
+    Stats[i].busy = 0;
+    total += Stats[i].load;
+  }
+  WindowStart = now;
+  return total;
+}
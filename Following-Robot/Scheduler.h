@@ -0,0 +1,60 @@
+// Scheduler.h
+// Runs on TM4C123, and on a host PC for testing
+// Rate-monotonic cooperative scheduler with a compile-time task table.
+// Scheduler_Tick() is called from the periodic tick ISR and releases
+// tasks whose period has come round. Scheduler_Run() is called from
+// the main loop and runs released tasks to completion, always picking
+// the released task that comes first in the table, so the table must
+// be sorted by period, fastest first (rate-monotonic priority).
+// Everything is statically allocated; there is no heap.
+// The module touches no hardware: the time source is a function
+// passed to Scheduler_Init(), e.g. SysTick_Cycles() on the robot or a
+// simulated counter on a host, see host/sched.c.
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+#include <stdint.h>
+
+#define SCHED_MAX_TASKS 8
+
+typedef struct {
+  void (*run)(void);        // must return; runs with interrupts enabled
+  uint16_t period;          // in ticks
+  uint16_t offset;          // first release after this many ticks, spreads the load
+} Task;
+
+typedef struct {
+  uint32_t runs;            // completed runs
+  uint32_t skipped;         // releases lost because the task was still waiting to run
+  uint32_t busy;            // execution time since the last Scheduler_Measure_Load()
+  uint32_t load;            // CPU share over the last load window, in 1/1000
+  uint32_t wcet;            // worst execution time of one run
+  uint32_t max_jitter;      // worst delay from release to start
+} TaskStats;
+
+// Start the scheduler with a task table of count entries
+// cycles returns a free-running time stamp, used only for statistics
+void Scheduler_Init(const Task *table, uint8_t count, uint32_t (*cycles)(void));
+
+// Release due tasks. Call once per tick from the tick ISR.
+void Scheduler_Tick(void);
+
+// Run released tasks, highest priority first, until none are left
+// Output: number of task runs executed
+uint32_t Scheduler_Run(void);
+
+// 1 if any task is released and waiting to run
+// Check with interrupts disabled before sleeping, so a release cannot
+// slip in between the check and the sleep
+uint8_t Scheduler_Ready(void);
+
+// Statistics for task i, in table order
+const TaskStats *Scheduler_Stats(uint8_t i);
+
+// Close the load window: set load from busy for every task and start a
+// new window. Call at a slow fixed rate, e.g. from a 10 Hz task; the
+// window must stay shorter than 2^32 time source units.
+// Output: total load of all tasks in 1/1000
+uint32_t Scheduler_Measure_Load(void);
+
+#endif
@@ -0,0 +1,44 @@
+// Search.c
+// Runs on TM4C123, and on a host PC for testing
+// Last-seen memory for the object follower's search, see Search.h.
+
+#include <stdint.h>
+#include "Search.h"
+#include "SysTickInts.h"
+
+static uint32_t LastSeen;       // stamp of the last frame with something in view
+static int32_t Bearing;         // right-left while in view, low-pass filtered
+static uint32_t SearchStart;    // stamp when the search started
+
+void Search_Reset(uint32_t now){
+  LastSeen = now;
+  Bearing = 0;
+}
+
+uint8_t Search_Track(uint16_t ahead, uint16_t left, uint16_t right, uint32_t now){
+  if ((ahead >= SEARCH_SEEN_DIST)||(left >= SEARCH_SEEN_DIST)||(right >= SEARCH_SEEN_DIST)){
+    LastSeen = now;
+    Bearing += ((int32_t)right - (int32_t)left - Bearing)/8;
+    return 1;
+  }
+  return 0;
+}
+
+uint8_t Search_Lost(uint32_t now){
+  return (now - LastSeen) >= MS_TO_TICKS(SEARCH_LOST_MS);
+}
+
+void Search_Start(uint32_t now){
+  SearchStart = now;
+}
+
+uint8_t Search_TimedOut(uint32_t now){
+  return (now - SearchStart) >= MS_TO_TICKS(SEARCH_TIMEOUT_MS);
+}
+
+// The way the follower's turn loop was steering when the target went
+// out of view
+void Search_Spin(int16_t *left, int16_t *right){
+  *left = (Bearing >= 0) ? -SEARCH_DUTY : SEARCH_DUTY;
+  *right = -*left;
+}
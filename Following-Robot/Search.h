@@ -0,0 +1,41 @@
+// Search.h
+// Runs on TM4C123, and on a host PC for testing
+// Last-seen memory for the object follower's search. Every control
+// tick Search_Track() notes whether anything is in view (any reading
+// at SEARCH_SEEN_DIST or more) and, while it is, low-pass filters the
+// right-left balance of the readings. Once nothing has been in view
+// for SEARCH_LOST_MS the target is lost, and Search_Spin() turns
+// towards the side it was last seen on. Times are in SysTick ticks,
+// as SensorFrame.stamp.
+// Behavior.c runs it in ST_FOLLOW and ST_SEARCH; host/search.c
+// measures how fast it reacquires a target.
+
+#ifndef SEARCH_H
+#define SEARCH_H
+#include <stdint.h>
+#include "Motors.h"
+
+#define SEARCH_SEEN_DIST  600       // a reading this high means something is in view; an empty cone reads about 300
+#define SEARCH_LOST_MS    200       // nothing in view this long: start searching
+#define SEARCH_TIMEOUT_MS 6000      // give up and stop, about two turns at SEARCH_DUTY
+#define SEARCH_DUTY       SPEED_35
+
+// The target is in view at now, side unknown
+void Search_Reset(uint32_t now);
+
+// Note one frame of readings taken at now
+// Output: 1 if something is in view
+uint8_t Search_Track(uint16_t ahead, uint16_t left, uint16_t right, uint32_t now);
+
+// 1 once nothing has been in view for SEARCH_LOST_MS
+uint8_t Search_Lost(uint32_t now);
+
+// The search starts at now; 1 from SEARCH_TIMEOUT_MS after that
+void Search_Start(uint32_t now);
+uint8_t Search_TimedOut(uint32_t now);
+
+// Signed wheel duties that spin towards the side the target was last
+// seen on, see Set_Wheels()
+void Search_Spin(int16_t *left, int16_t *right);
+
+#endif
@@ -0,0 +1,54 @@
+// Sensors.c
+// Runs on TM4C123
+// Double-buffered sensor frame with a sequence count, see Sensors.h.
+
+#include <stdint.h>
+#include "Sensors.h"
+#include "CycleCount.h"
+
+// Keeps the compiler from moving frame copies across Seq accesses.
+// Single core, no caches, so the M4 needs no DMB here.
+#define SEQ_BARRIER() __asm volatile("" ::: "memory")
+
+static SensorFrame Frames[2];
+static volatile uint32_t Seq;     // Frames[Seq&1] is current
+
+uint32_t Sensors_WriteCycles, Sensors_ReadCycles;
+
+void Sensors_Publish(const SensorFrame *frame){
+  uint32_t next = Seq + 1;
+  Frames[next&1] = *frame;        // readers are on Frames[Seq&1]
+  SEQ_BARRIER();
+  Seq = next;
+}
+
+uint32_t Sensors_Read(SensorFrame *frame){
+  uint32_t seq;
+  uint32_t retries = 0;
+  while(1){
+    seq = Seq;
+    SEQ_BARRIER();
+    *frame = Frames[seq&1];
+    SEQ_BARRIER();
+    if (Seq == seq){              // no publication started on our buffer
+      return retries;
+    }
+    retries++;
+  }
+}
+
+uint32_t Sensors_Seq(void){
+  return Seq;
+}
+
+void Sensors_Bench(void){
+  SensorFrame frame;
+  uint32_t start;
+  Sensors_Read(&frame);           // republish what is there
+  start = CYCLES();
+  Sensors_Publish(&frame);
+  Sensors_WriteCycles = CYCLES() - start;
+  start = CYCLES();
+  Sensors_Read(&frame);
+  Sensors_ReadCycles = CYCLES() - start;
+}
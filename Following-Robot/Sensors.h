@@ -0,0 +1,44 @@
+// Sensors.h
+// Runs on TM4C123
+// Publication of IR sensor frames from one writer to any number of
+// readers without disabling interrupts.
+// Two frame buffers and a sequence count: the writer fills the buffer
+// the readers are not using, then bumps Seq, which makes it current.
+// A reader copies the current buffer and retries if Seq moved while it
+// was copying. A reader that preempts the writer (an ISR, or a higher
+// priority thread) always gets the previous frame whole on the first
+// try, because the writer cannot be overwriting that buffer. Only
+// readers the writer can preempt may retry, once per publication.
+// There must be a single writer (Safety_Thread).
+
+#ifndef SENSORS_H
+#define SENSORS_H
+#include <stdint.h>
+#include "Trace.h"
+
+typedef struct {
+  uint16_t ahead, left, right;    // filtered ADC readings, larger is closer
+  uint32_t stamp;                 // Ticks when the frame was published
+#ifdef TRACE
+  uint32_t t_start, t_filter;     // CYCLES() at ADC trigger and filter output
+#endif
+} SensorFrame;
+
+// Make frame the current one. Single writer only.
+void Sensors_Publish(const SensorFrame *frame);
+
+// Copy the current frame
+// Output: number of retries needed, 0 when undisturbed
+uint32_t Sensors_Read(SensorFrame *frame);
+
+// Number of publications since reset
+uint32_t Sensors_Seq(void);
+
+// Time Sensors_Publish and Sensors_Read with the DWT cycle counter
+// Results, in core cycles, are left in Sensors_WriteCycles and
+// Sensors_ReadCycles. Call once before the writer starts, with the
+// cycle counter running (OS_Init() starts it).
+void Sensors_Bench(void);
+extern uint32_t Sensors_WriteCycles, Sensors_ReadCycles;
+
+#endif
@@ -12,8 +12,22 @@
 #include "ADC0SS2.h"  
 #include "Motors.h"
 #include "PLL.h"
+#include "SysTickInts.h"
+#include "Params.h"
+#include "Calibrate.h"
+#include "Odometry.h"
+#include "Motion.h"
+#include "Trajectory.h"
+#include "Stall.h"
+#include "EStop.h"
+#include "Scheduler.h"
+#include "OS.h"
+#include "Power.h"
+#include "Buttons.h"
+#include "Sensors.h"
+#include "Trace.h"
+#include "Behavior.h"
 
-void object_steering(uint16_t ahead, uint16_t left, uint16_t right);
 void wall_steering(uint16_t ahead, uint16_t left, uint16_t right);
 void SwitchLED_Init(void);
 
@@ -21,94 +35,165 @@ extern void DisableInterrupts(void); // Disable interrupts
 extern void EnableInterrupts(void);  // Enable interrupts
 extern void WaitForInterrupt(void);  // low power mode
 
-int mode, active; //1 Object Follower, 2 Left Wall Follower, 3 Right Wall Follower
-uint16_t global_left, global_right, global_ahead;
+// Rate groups, each must divide TICK_HZ
+#define SENSE_HZ   1000           // IR sensors, median filter and stop check (Safety_Thread)
+#define CONTROL_HZ 500            // steering decision and motor commands
+#define HEALTH_HZ  10             // CPU load and idle figures
+#if ((TICK_HZ % SENSE_HZ) != 0)||((TICK_HZ % CONTROL_HZ) != 0)||((TICK_HZ % HEALTH_HZ) != 0)
+#error "SENSE_HZ, CONTROL_HZ and HEALTH_HZ must divide TICK_HZ"
+#endif
+
+uint32_t CpuLoad;                 // all tasks, 1/1000, refreshed by Health_Task
+uint32_t IdleShare;               // time in WFI, 1/1000, refreshed by Health_Task
+uint32_t StackFree[OS_MAX_THREADS]; // unused stack words per thread priority, refreshed by Health_Task
+#ifdef TRACE
+volatile uint8_t TraceDumpRequest; // set from the debugger, Health_Task fills TraceReport
+TraceStat TraceReport[TRACE_SPANS];
+#endif
+
+static void Control_Task(void){
+	SensorFrame ir;
+	Sensors_Read(&ir);        // one consistent frame for the whole decision
+	TRACE_DECIDE_POINT();
+	Behavior_Step(&ir);
+#ifdef TRACE
+	Trace_Record(SPAN_WAIT, Trace_Stamp[TRACE_DECIDE] - ir.t_filter);
+	if (Trace_Armed == 0){    // a PWM register was written
+		Trace_Record(SPAN_DECIDE, Trace_Stamp[TRACE_COMMIT] - Trace_Stamp[TRACE_DECIDE]);
+		Trace_Record(SPAN_TOTAL, Trace_Stamp[TRACE_COMMIT] - ir.t_start);
+	}
+	Trace_Armed = 0;
+#endif
+}
+
+static void Health_Task(void){
+	CpuLoad = Scheduler_Measure_Load();
+	IdleShare = Power_Measure_Idle();
+	for (uint8_t i=0;i<OS_MAX_THREADS;i++) {
+		StackFree[i] = OS_StackFree(i); // watermark: 0 means overflowed
+	}
+#ifdef TRACE
+	if (TraceDumpRequest){
+		Trace_Dump(TraceReport);
+		TraceDumpRequest = 0;
+	}
+#endif
+}
+
+// Task table, fastest first. Per-task run counts, WCET, jitter and
+// load are in Scheduler_Stats(i). These run cooperatively inside
+// Scheduler_Thread and can be preempted by Safety_Thread.
+static const Task Tasks[] = {
+	{Control_Task, TICK_HZ/CONTROL_HZ, 0},
+	{Health_Task,  TICK_HZ/HEALTH_HZ,  1},
+};
+
+// Kernel threads, 0 is the highest priority
+#define SAFETY_PRI    0
+#define SCHEDULER_PRI 1
+#define IDLE_PRI      2
+
+// Sample the IR sensors and brake at once if the object follower is
+// about to hit something, however long the cooperative tasks take.
+// Backing off is left to the avoid layer in Behavior.c.
+// Only ahead is checked here on purpose: the avoid layer brakes once
+// for something inside STOP_DIST on the left or right and then lets
+// the follower steer away. Braking on every sample here would hold the
+// robot still beside the obstacle.
+// Sole writer of the published sensor frame.
+static void Safety_Thread(void){
+	SensorFrame ir;
+	while(1){
+		ReadADCMedianFilter(&ir.ahead, &ir.right, &ir.left);
+		ir.stamp = Ticks;
+#ifdef TRACE
+		ir.t_start = Trace_Stamp[TRACE_ADC_START];
+		ir.t_filter = Trace_Stamp[TRACE_FILTER];
+		Trace_Record(SPAN_CONVERT, Trace_Stamp[TRACE_ADC_DONE] - ir.t_start);
+		Trace_Record(SPAN_FILTER, ir.t_filter - Trace_Stamp[TRACE_ADC_DONE]);
+#endif
+		Sensors_Publish(&ir);
+		if ((Behavior_State() == ST_FOLLOW)&&(ir.ahead > STOP_DIST)
+		    &&(Motion_Status() != MOTION_BUSY)&&!Trajectory_Busy()){
+			Stop_Both_Wheels_Mode(STOP_BRAKE);
+		}
+		OS_Sleep(TICK_HZ/SENSE_HZ);
+	}
+}
+
+// Run released cooperative tasks, sleep until the next tick when none are left
+static void Scheduler_Thread(void){
+	while(1){
+		Scheduler_Run();
+		if (!Scheduler_Ready()){
+			OS_Sleep(1);
+		}
+	}
+}
+
+// Sleep between ticks, deep sleep while inactive
+static void Idle_Thread(void){
+	while(1){
+		Power_Idle();
+	}
+}
 
 int main(void){	
+	SensorFrame ir;
 	
   PLL_Init();               // set system clock to 16 MHz 
+	Params_Load();            // wheel trim from EEPROM, identity if never calibrated
 	ADC0_SS2_Init213();       // Initialize ADC0 Sample sequencer 2 to AIN4 (PD3), AIN9 (PE4), AIN8 (PE5)
 	Wheels_PWM_Init();
+	EStop_Init();             // bumper on PD2 trips the PWM fault input
 	Dir_Init();
+	Odometry_Init();
+	Trajectory_Init();
 	Set_L_Speed(SPEED_98);
 	Set_R_Speed(SPEED_98);
 	
 
   // calibrate the sensors
 	for (uint8_t i=0;i<10;i++) {
-			ReadADCMedianFilter(&global_ahead, &global_right, &global_left);
+			ReadADCMedianFilter(&ir.ahead, &ir.right, &ir.left);
 	}	
+	ir.stamp = 0;
+	Sensors_Publish(&ir);
 	
+	SysTick_Init(BUS_CLOCK/TICK_HZ); // 1 ms time base: control tick, odometry, motion, driver power
 	EnableInterrupts();
 	SwitchLED_Init();
+	Buttons_Init();           // debounce timer and event queue for SW1/SW2
+	
+	if ((GPIO_PORTF_DATA_R&0x10) == 0){ // SW1 held during reset: calibrate wheel trim
+		LIGHT = RED|GREEN;
+		Calibrate_Wheels();
+		while ((GPIO_PORTF_DATA_R&0x10) == 0){} // wait for SW1 to be let go
+	}
 	
 	LIGHT = RED;
 	
-	mode = 1;
-	active = 0;
+	Buttons_Flush();          // the SW1 release above must not start the robot
+	Behavior_Init();          // idle, SW1 starts the object follower
 
-  while(1){
-		ReadADCMedianFilter(&global_ahead, &global_right, &global_left);
-		object_steering(global_ahead, global_right, global_left);
-  }
+	Scheduler_Init(Tasks, sizeof(Tasks)/sizeof(Tasks[0]), SysTick_Cycles);
+	OS_Init();
+	Sensors_Bench();          // frame publish/read cost in Sensors_WriteCycles/ReadCycles
+	OS_AddThread(Safety_Thread, SAFETY_PRI);
+	OS_AddThread(Scheduler_Thread, SCHEDULER_PRI);
+	OS_AddThread(Idle_Thread, IDLE_PRI);
+	OS_Start();               // does not return
 }
 
-// Simple steering function to help students get started with project 2.
-void object_steering(uint16_t ahead, uint16_t right, uint16_t left){
-	if (active == 1){
-		if (mode==1){
-			LIGHT = BLUE;
-			if ((ahead > STOP_DIST)||(left > STOP_DIST)||(right > STOP_DIST)) {
-				Stop_Both_Wheels();
-				while(ahead > FOLLOW_DIST + 200){
-					Move_Backward();
-					return;
-				}
-			}
-			if (ahead < FOLLOW_DIST) { //Object Nearby. Follow Object
-				DIRECTION = FORWARD;
-				if (left < FOLLOW_DIST){  // right side is closer to an object
-					Set_R_Speed(SPEED_35);
-					Start_R();
-				}else{
-					Stop_R();
-				}
-				if (right < FOLLOW_DIST){
-					Set_L_Speed(SPEED_35);
-					Start_L(); // left side is closer to an object
-				}else{
-					Stop_L();
-				}
-				return;
-			}
-		}
-		if ((mode == 2 ) || (mode == 3)){
-			LIGHT = GREEN;
-			if (mode == 2){ //Left Wall Follower
-				if (left < WALL_DIST){ //If none on left side
-					Move_Left_Forward();
-					return;
-				}
-				if (ahead > WALL_DIST){ //If wall ahead
-					Move_Right_Pivot();
-					return;
-				}
-			}else if (mode == 3){ //Right Wall Follower
-				if  (right < WALL_DIST){ //If none on left side
-					Move_Right_Forward();
-					return;
-				}
-				if (ahead > WALL_DIST){ //If wall ahead
-					Move_Left_Pivot();
-					return;
-				}
-		}
-		Move_Forward();
-		}
-	}else{
-		Stop_Both_Wheels();
-		LIGHT = RED;
-	}
+void SysTick_Handler(void){
+	Ticks++;
+	Scheduler_Tick();
+	Odometry_Update();
+	Stall_Tick();
+	Motion_Tick();
+	Trajectory_Tick();
+	Motors_Sleep_Tick();
+	OS_Tick();                // last: may pend a context switch
 }
 
 // Initilize port F and arm PF4, PF0 for falling edge interrupts
@@ -135,28 +220,3 @@ void SwitchLED_Init(void){
   GPIO_PORTF_DATA_R &= ~0x0E;   	// make PF1-3 low
 	GPIO_PORTF_DATA_R |= RED; 		//make LED red
 }
-
-void GPIOPortF_Handler(void){
-	if(GPIO_PORTF_RIS_R&0x01){ //Mode toggle
-		GPIO_PORTF_ICR_R = 0x01;
-		if (active == 1){ //If only active
-			if(mode == 1){
-				if (global_left > global_right){ //Left Mode
-					mode = 2;
-				}else{
-					mode = 3;
-				}
-			}else{
-				mode = 1;
-			}
-		}
-	}else{ //Activation
-		GPIO_PORTF_ICR_R = 0x10;
-		if (active == 1){
-			active = 0;
-		}else{
-			active = 1;
-		}
-	}
-}
-
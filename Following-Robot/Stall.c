@@ -0,0 +1,58 @@
+// Stall.c
+// Runs on TM4C123
+// Wheel stall detection from the encoders.
+
+#include <stdint.h>
+#include "Stall.h"
+#include "WheelWatch.h"
+#include "Motors.h"
+#include "Odometry.h"
+#include "SysTickInts.h"
+#include "tm4c123gh6pm.h"
+
+static WheelWatch Left, Right;
+static uint32_t WindowTicks;
+static volatile uint8_t Detected;
+static volatile uint8_t ClearRequest;  // set by Stall_Clear, handled in the ISR
+static uint32_t Count;
+
+// The enable and duty are sampled every tick, so a wheel switched off or
+// slowed down inside a window is seen
+void Stall_Tick(void){
+  uint32_t enable = PWM0_ENABLE_R;
+  uint8_t stalled;
+  if (ClearRequest){                   // the ISR owns the watches
+    WheelWatch_Reset(&Left, Odometry_Left_Counts());
+    WheelWatch_Reset(&Right, Odometry_Right_Counts());
+    WindowTicks = 0;
+    ClearRequest = 0;
+  }
+  WheelWatch_Sample(&Left, Odometry_Left_Counts(), (enable&0x04) != 0, PWM0_1_CMPA_R + 1);
+  WheelWatch_Sample(&Right, Odometry_Right_Counts(), (enable&0x08) != 0, PWM0_1_CMPB_R + 1);
+  if (++WindowTicks < MS_TO_TICKS(STALL_WINDOW_MS)){
+    return;
+  }
+  WindowTicks = 0;
+  stalled = WheelWatch_End(&Left);
+  stalled |= WheelWatch_End(&Right);
+  if (stalled && !Detected){
+    Motors_Lockout(LOCKOUT_STALL, 1);
+    Stop_Both_Wheels_Mode(STOP_COAST);
+    Detected = 1;
+    Count++;
+  }
+}
+
+uint8_t Stall_Detected(void){
+  return Detected;
+}
+
+void Stall_Clear(void){
+  ClearRequest = 1;           // before Detected, so old bad windows cannot trip again
+  Detected = 0;
+  Motors_Lockout(LOCKOUT_STALL, 0);
+}
+
+uint32_t Stall_Count(void){
+  return Count;
+}
@@ -0,0 +1,35 @@
+// Stall.h
+// Runs on TM4C123
+// Wheel stall detection from the encoders.
+// Every STALL_WINDOW_MS the travel of each driven wheel is compared
+// with what its duty cycle, summed every tick, should give on a
+// free-running wheel (WheelWatch.c). A wheel
+// that makes less than STALL_FRACTION_PCT of that for STALL_WINDOWS
+// windows in a row is stalled: the drivers are cut (coast) and locked
+// out until the behaviour code calls Stall_Clear(). Worst-case time
+// from jam to cut is (STALL_WINDOWS+1)*STALL_WINDOW_MS.
+// The DRV8838 has no current sense output, so only the encoders are used.
+
+#ifndef STALL_H
+#define STALL_H
+#include <stdint.h>
+
+#define STALL_WINDOW_MS    100
+#define STALL_WINDOWS      3
+#define STALL_MAX_CPS      3600             // encoder counts/s of a free wheel at 100% duty
+#define STALL_FRACTION_PCT 20
+#define STALL_MIN_DUTY     (PERIOD*20/100)  // lower duties may not turn the wheel at all
+
+// Call from the SysTick ISR after Odometry_Update()
+void Stall_Tick(void);
+
+// 1 once a stall has cut the motors, until Stall_Clear()
+uint8_t Stall_Detected(void);
+
+// Release the motor lockout and start watching again
+void Stall_Clear(void);
+
+// Number of stalls since reset
+uint32_t Stall_Count(void);
+
+#endif
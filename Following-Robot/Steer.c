@@ -0,0 +1,38 @@
+// Steer.c
+// Runs on TM4C123, and on a host PC for testing
+// The original bang-bang steering decisions, see Steer.h.
+
+#include <stdint.h>
+#include "Steer.h"
+#include "ADC0SS2.h"
+
+uint8_t Steer_Decide(uint8_t policy, uint16_t ahead, uint16_t left, uint16_t right){
+  uint8_t cmd = 0;
+  uint16_t side;
+  if (policy == STEER_POLICY_FOLLOW){
+    if ((ahead > STOP_DIST)||(left > STOP_DIST)||(right > STOP_DIST)) {
+      cmd |= STEER_BRAKE;
+      if (ahead > FOLLOW_DIST + 200){
+        return cmd|STEER_BACKOFF;
+      }
+    }
+    if (ahead < FOLLOW_DIST) { //Object Nearby. Follow Object
+      cmd |= STEER_FOLLOW;
+      if (left < FOLLOW_DIST){  // right side is closer to an object
+        cmd |= STEER_R;
+      }
+      if (right < FOLLOW_DIST){ // left side is closer to an object
+        cmd |= STEER_L;
+      }
+    }
+    return cmd;
+  }
+  side = (policy == STEER_POLICY_WALL_LEFT) ? left : right;
+  if (side < WALL_DIST){ //If none on the wall side
+    return STEER_IN;
+  }
+  if (ahead > WALL_DIST){ //If wall ahead
+    return STEER_PIVOT;
+  }
+  return STEER_AHEAD;
+}
@@ -0,0 +1,15 @@
+// Steer.h
+// Runs on TM4C123, and on a host PC for testing
+// The original bang-bang steering decisions as branches, the reference
+// SteerLut[] was generated from. Behavior.c calls it under STEER_LUT=0;
+// host/steerlut.c checks the table against it over the reading grid.
+
+#ifndef STEER_H
+#define STEER_H
+#include <stdint.h>
+#include "SteerLut.h"
+
+// Command bits (STEER_xx in SteerLut.h) for policy and the three readings
+uint8_t Steer_Decide(uint8_t policy, uint16_t ahead, uint16_t left, uint16_t right);
+
+#endif
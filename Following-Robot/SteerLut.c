@@ -0,0 +1,74 @@
+// SteerLut.c
+// Generated by gen_steer_lut.py from ADC0SS2.h, do not edit.
+// Cell table for SteerLut.h, index [policy][STEER_CELL(ahead,left,right)].
+
+#include <stdint.h>
+#include "SteerLut.h"
+#include "ADC0SS2.h"
+
+#if (WALL_DIST != 1150)||(FOLLOW_DIST != 2500)||(STOP_DIST != 3000)
+#error "SteerLut.c is out of date, rerun gen_steer_lut.py"
+#endif
+
+const uint8_t SteerLut[STEER_POLICIES][STEER_CELLS] = {
+  { // STEER_POLICY_FOLLOW
+    0x1C,0x1C,0x1C,0x0C,0x0C,0x0D,0x1C,0x1C,0x1C,0x0C,0x0C,0x0D,
+    0x1C,0x1C,0x1C,0x0C,0x0C,0x0D,0x14,0x14,0x14,0x04,0x04,0x05,
+    0x14,0x14,0x14,0x04,0x04,0x05,0x15,0x15,0x15,0x05,0x05,0x05,
+    0x1C,0x1C,0x1C,0x0C,0x0C,0x0D,0x1C,0x1C,0x1C,0x0C,0x0C,0x0D,
+    0x1C,0x1C,0x1C,0x0C,0x0C,0x0D,0x14,0x14,0x14,0x04,0x04,0x05,
+    0x14,0x14,0x14,0x04,0x04,0x05,0x15,0x15,0x15,0x05,0x05,0x05,
+    0x1C,0x1C,0x1C,0x0C,0x0C,0x0D,0x1C,0x1C,0x1C,0x0C,0x0C,0x0D,
+    0x1C,0x1C,0x1C,0x0C,0x0C,0x0D,0x14,0x14,0x14,0x04,0x04,0x05,
+    0x14,0x14,0x14,0x04,0x04,0x05,0x15,0x15,0x15,0x05,0x05,0x05,
+    0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,
+    0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,
+    0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x01,0x01,0x01,0x01,0x01,
+    0x00,0x00,0x00,0x00,0x00,0x03,0x00,0x00,0x00,0x00,0x00,0x03,
+    0x00,0x00,0x00,0x00,0x00,0x03,0x00,0x00,0x00,0x00,0x00,0x03,
+    0x00,0x00,0x00,0x00,0x00,0x03,0x03,0x03,0x03,0x03,0x03,0x03,
+    0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,
+    0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,
+    0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,0x03,
+  },
+  { // STEER_POLICY_WALL_LEFT
+    0x20,0x20,0x20,0x20,0x20,0x20,0x80,0x80,0x80,0x80,0x80,0x80,
+    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
+    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
+    0x20,0x20,0x20,0x20,0x20,0x20,0x80,0x80,0x80,0x80,0x80,0x80,
+    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
+    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
+    0x20,0x20,0x20,0x20,0x20,0x20,0x40,0x40,0x40,0x40,0x40,0x40,
+    0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,
+    0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,
+    0x20,0x20,0x20,0x20,0x20,0x20,0x40,0x40,0x40,0x40,0x40,0x40,
+    0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,
+    0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,
+    0x20,0x20,0x20,0x20,0x20,0x20,0x40,0x40,0x40,0x40,0x40,0x40,
+    0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,
+    0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,
+    0x20,0x20,0x20,0x20,0x20,0x20,0x40,0x40,0x40,0x40,0x40,0x40,
+    0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,
+    0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,0x40,
+  },
+  { // STEER_POLICY_WALL_RIGHT
+    0x20,0x80,0x80,0x80,0x80,0x80,0x20,0x80,0x80,0x80,0x80,0x80,
+    0x20,0x80,0x80,0x80,0x80,0x80,0x20,0x80,0x80,0x80,0x80,0x80,
+    0x20,0x80,0x80,0x80,0x80,0x80,0x20,0x80,0x80,0x80,0x80,0x80,
+    0x20,0x80,0x80,0x80,0x80,0x80,0x20,0x80,0x80,0x80,0x80,0x80,
+    0x20,0x80,0x80,0x80,0x80,0x80,0x20,0x80,0x80,0x80,0x80,0x80,
+    0x20,0x80,0x80,0x80,0x80,0x80,0x20,0x80,0x80,0x80,0x80,0x80,
+    0x20,0x40,0x40,0x40,0x40,0x40,0x20,0x40,0x40,0x40,0x40,0x40,
+    0x20,0x40,0x40,0x40,0x40,0x40,0x20,0x40,0x40,0x40,0x40,0x40,
+    0x20,0x40,0x40,0x40,0x40,0x40,0x20,0x40,0x40,0x40,0x40,0x40,
+    0x20,0x40,0x40,0x40,0x40,0x40,0x20,0x40,0x40,0x40,0x40,0x40,
+    0x20,0x40,0x40,0x40,0x40,0x40,0x20,0x40,0x40,0x40,0x40,0x40,
+    0x20,0x40,0x40,0x40,0x40,0x40,0x20,0x40,0x40,0x40,0x40,0x40,
+    0x20,0x40,0x40,0x40,0x40,0x40,0x20,0x40,0x40,0x40,0x40,0x40,
+    0x20,0x40,0x40,0x40,0x40,0x40,0x20,0x40,0x40,0x40,0x40,0x40,
+    0x20,0x40,0x40,0x40,0x40,0x40,0x20,0x40,0x40,0x40,0x40,0x40,
+    0x20,0x40,0x40,0x40,0x40,0x40,0x20,0x40,0x40,0x40,0x40,0x40,
+    0x20,0x40,0x40,0x40,0x40,0x40,0x20,0x40,0x40,0x40,0x40,0x40,
+    0x20,0x40,0x40,0x40,0x40,0x40,0x20,0x40,0x40,0x40,0x40,0x40,
+  },
+};
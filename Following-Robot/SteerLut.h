@@ -0,0 +1,51 @@
+// SteerLut.h
+// Runs on TM4C123, and on a host PC for testing
+// Precomputed decisions of the original bang-bang steering.
+// Those decisions depend on each IR reading only through comparisons
+// with WALL_DIST, FOLLOW_DIST, FOLLOW_DIST+200 and STOP_DIST, so each
+// reading is cut into STEER_BINS cells where every comparison has a
+// fixed result. STEER_CELL() finds the cell with five comparisons and
+// no branches; one byte per (policy, ahead, left, right) cell holds
+// the command bits. SteerLut.c is generated by gen_steer_lut.py, which
+// also checks the table against a reference model for every 12-bit
+// reading; rerun it after changing any of the thresholds. The models
+// in the script are copies, so host/steerlut.c checks the table again
+// with this STEER_CELL() against Steer_Decide() in Steer.c.
+// Cost: 648 bytes of flash, and no cycles saved. Counted by hand from
+// the C, STEER_CELL() and the load are about 45 to 55 cycles on the M4
+// for every reading, the longest branchy path about 15 to 20. What the
+// table buys is one path whatever the readings. SPAN_DECIDE in a TRACE
+// build measures the decide step on the robot.
+
+#ifndef STEERLUT_H
+#define STEERLUT_H
+#include <stdint.h>
+
+#define STEER_POLICY_FOLLOW     0   // mode 1
+#define STEER_POLICY_WALL_LEFT  1   // mode 2
+#define STEER_POLICY_WALL_RIGHT 2   // mode 3
+#define STEER_POLICIES          3
+
+#define STEER_BINS  6
+#define STEER_CELLS (STEER_BINS*STEER_BINS*STEER_BINS)
+
+// 0: below WALL_DIST, 1: at WALL_DIST, 2: above it and below FOLLOW_DIST,
+// 3: FOLLOW_DIST..FOLLOW_DIST+200, 4: up to STOP_DIST, 5: above STOP_DIST
+#define STEER_BIN(v) (((v) >= WALL_DIST) + ((v) > WALL_DIST) + ((v) >= FOLLOW_DIST) \
+                    + ((v) > FOLLOW_DIST + 200) + ((v) > STOP_DIST))
+#define STEER_CELL(ahead,left,right) \
+  ((STEER_BIN(ahead)*STEER_BINS + STEER_BIN(left))*STEER_BINS + STEER_BIN(right))
+
+// Command bits, applied in this order
+#define STEER_BRAKE   0x01          // Stop_Both_Wheels_Mode(STOP_BRAKE)
+#define STEER_BACKOFF 0x02          // queue the reverse segment, nothing else
+#define STEER_FOLLOW  0x04          // DIRECTION = FORWARD, then STEER_L/STEER_R
+#define STEER_R       0x08          //   right wheel at SPEED_35, else stopped
+#define STEER_L       0x10          //   left wheel at SPEED_35, else stopped
+#define STEER_IN      0x20          // Move_Left_Forward (mode 2) / Move_Right_Forward (mode 3)
+#define STEER_PIVOT   0x40          // corner pivot away from the wall
+#define STEER_AHEAD   0x80          // Move_Forward
+
+extern const uint8_t SteerLut[STEER_POLICIES][STEER_CELLS];
+
+#endif
@@ -0,0 +1,38 @@
+// SysTickInts.c
+// Runs on TM4C123
+// Use the SysTick timer to request interrupts at a fixed rate.
+// SysTick_Handler is provided by the application (SpaceExplorer.c)
+// and must increment Ticks once per interrupt.
+
+#include <stdint.h>
+#include "SysTickInts.h"
+#include "tm4c123gh6pm.h"
+
+volatile uint32_t Ticks;
+static uint32_t Period;         // bus cycles per tick
+
+// Initialize SysTick periodic interrupts
+// Input: interrupt period in bus cycles
+// Output: none
+void SysTick_Init(uint32_t period){
+  NVIC_ST_CTRL_R = 0;           // disable SysTick during setup
+  Period = period;
+  NVIC_ST_RELOAD_R = period-1;  // reload value
+  NVIC_ST_CURRENT_R = 0;        // any write to current clears it
+  NVIC_SYS_PRI3_R = (NVIC_SYS_PRI3_R&0x00FFFFFF)|0x40000000; // priority 2
+  Ticks = 0;
+  NVIC_ST_CTRL_R = NVIC_ST_CTRL_ENABLE|NVIC_ST_CTRL_INTEN|NVIC_ST_CTRL_CLK_SRC; // core clock, interrupts on
+}
+
+uint32_t SysTick_Cycles(void){
+  uint32_t t, pending, current;
+  do{
+    t = Ticks;
+    pending = NVIC_INT_CTRL_R&NVIC_INT_CTRL_PENDSTSET;
+    current = NVIC_ST_CURRENT_R;  // counts down from Period-1
+  }while((t != Ticks)||(pending != (NVIC_INT_CTRL_R&NVIC_INT_CTRL_PENDSTSET))); // a tick in between: read again
+  if (pending){                   // counter reloaded, Ticks++ not run yet
+    t++;
+  }
+  return t*Period + (Period-1-current);
+}
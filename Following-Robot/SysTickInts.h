@@ -0,0 +1,26 @@
+// SysTickInts.h
+// Runs on TM4C123
+// Use the SysTick timer to request interrupts at a fixed rate.
+// SysTick_Handler is provided by the application (SpaceExplorer.c)
+// and must increment Ticks once per interrupt.
+
+#include <stdint.h>
+
+#define TICK_HZ 1000              // SysTick interrupt rate, 1 ms per tick
+#define MS_TO_TICKS(ms) ((uint32_t)(ms)*TICK_HZ/1000)
+
+extern volatile uint32_t Ticks;   // number of SysTick interrupts since SysTick_Init()
+
+// Free-running bus cycle count built from Ticks and the SysTick counter.
+// Wraps every 2^32 cycles (268 s at 16 MHz); use differences only.
+// Valid with interrupts masked too, as long as no more than one tick
+// is left pending.
+uint32_t SysTick_Cycles(void);
+
+// Initialize SysTick periodic interrupts
+// Input: interrupt period in bus cycles, e.g. BUS_CLOCK/TICK_HZ
+//        Units of period are 62.5ns at 16 MHz
+//        Maximum is 2^24-1
+//        Minimum is determined by length of ISR
+// Output: none
+void SysTick_Init(uint32_t period);
@@ -0,0 +1,69 @@
+// Trace.c
+// Runs on TM4C123
+// Latency statistics for the trace points in Trace.h.
+
+#include <stdint.h>
+#include "Trace.h"
+
+#ifdef TRACE
+
+long StartCritical(void);     // previous I bit, disable interrupts
+void EndCritical(long sr);    // restore I bit to previous value
+
+volatile uint32_t Trace_Stamp[TRACE_POINTS];
+volatile uint8_t Trace_Armed;
+
+static TraceStat Stats[TRACE_SPANS];
+
+TraceEvent Trace_Events[TRACE_LOG_SIZE];
+uint32_t Trace_EventCount;
+
+void Trace_Record(uint8_t span, uint32_t cycles){
+  TraceStat *s = &Stats[span];
+  uint8_t bin = 0;
+  long sr;
+  while((bin < TRACE_BINS-1)&&((cycles>>(bin+1)) != 0)){
+    bin++;
+  }
+  sr = StartCritical();       // Trace_Dump may run at another priority
+  if ((s->count == 0)||(cycles < s->min)){
+    s->min = cycles;
+  }
+  if (cycles > s->max){
+    s->max = cycles;
+  }
+  s->sum += cycles;
+  s->count++;
+  s->hist[bin]++;
+  EndCritical(sr);
+}
+
+void Trace_Dump(TraceStat *out){
+  uint8_t i, j;
+  long sr = StartCritical();
+  for(i=0; i<TRACE_SPANS; i++){
+    out[i] = Stats[i];
+    Stats[i].count = 0;
+    Stats[i].min = Stats[i].max = 0;
+    Stats[i].sum = 0;
+    for(j=0; j<TRACE_BINS; j++){
+      Stats[i].hist[j] = 0;
+    }
+  }
+  EndCritical(sr);
+}
+
+void Trace_Log(uint8_t code, uint8_t a, uint8_t b, uint8_t c){
+  TraceEvent *e;
+  long sr = StartCritical();
+  e = &Trace_Events[Trace_EventCount&(TRACE_LOG_SIZE-1)];
+  e->stamp = CYCLES();
+  e->code = code;
+  e->a = a;
+  e->b = b;
+  e->c = c;
+  Trace_EventCount++;
+  EndCritical(sr);
+}
+
+#endif
@@ -0,0 +1,97 @@
+// Trace.h
+// Runs on TM4C123
+// Sense-to-actuate latency tracing with the DWT cycle counter.
+// Stamps are taken at five points along the path of one IR sample:
+//   TRACE_ADC_START  software trigger of ADC0 SS2
+//   TRACE_ADC_DONE   conversion complete
+//   TRACE_FILTER     median filter output
+//   TRACE_DECIDE     Control_Task has the frame and starts deciding
+//   TRACE_COMMIT     first PWM register write after TRACE_DECIDE
+// and turned into five spans, each with min/avg/max and a log2
+// histogram in RAM:
+//   SPAN_CONVERT  ADC_START -> ADC_DONE
+//   SPAN_FILTER   ADC_DONE  -> FILTER
+//   SPAN_WAIT     FILTER    -> DECIDE, frame age from loop pacing
+//   SPAN_DECIDE   DECIDE    -> COMMIT, steering logic and motor calls
+//   SPAN_TOTAL    ADC_START -> COMMIT, end to end
+// Trace_Log() also keeps the last TRACE_LOG_SIZE discrete events, e.g.
+// behaviour transitions, with their cycle stamp.
+// Decisions that write no PWM register are not counted in
+// SPAN_DECIDE/TOTAL; a motion ISR writing the PWM while a decision is
+// running would be taken as its commit. Trace_Dump() copies out all spans and starts
+// over, for the debugger or a telemetry task.
+// Without TRACE defined every macro here is empty and Trace.c
+// compiles to nothing. Define it in the project (Options for Target,
+// C/C++, Define) or uncomment the line below.
+
+#ifndef TRACE_H
+#define TRACE_H
+#include <stdint.h>
+
+// #define TRACE
+
+#define TRACE_ADC_START 0
+#define TRACE_ADC_DONE  1
+#define TRACE_FILTER    2
+#define TRACE_DECIDE    3
+#define TRACE_COMMIT    4
+#define TRACE_POINTS    5
+
+#define SPAN_CONVERT 0
+#define SPAN_FILTER  1
+#define SPAN_WAIT    2
+#define SPAN_DECIDE  3
+#define SPAN_TOTAL   4
+#define TRACE_SPANS  5
+
+#define TRACE_BINS 16               // bin i: 2^i to 2^(i+1)-1 cycles, last bin and up
+
+#define TRACE_LOG_SIZE 32           // power of 2
+#define TRACE_EV_TRANSITION 1       // a = from state, b = event, c = to state
+
+typedef struct {
+  uint32_t stamp;                   // CYCLES() when logged
+  uint8_t code, a, b, c;
+} TraceEvent;
+
+typedef struct {
+  uint32_t count;
+  uint32_t min, max;                // core cycles
+  uint64_t sum;                     // avg = sum/count
+  uint32_t hist[TRACE_BINS];
+} TraceStat;
+
+#ifdef TRACE
+#include "CycleCount.h"
+
+extern volatile uint32_t Trace_Stamp[TRACE_POINTS];
+extern volatile uint8_t Trace_Armed;
+
+// Cycle count at point
+#define TRACE_STAMP(point) (Trace_Stamp[point] = CYCLES())
+// Stamp TRACE_COMMIT once per decision, at the first register write
+#define TRACE_COMMIT_POINT() do{ if (Trace_Armed){ TRACE_STAMP(TRACE_COMMIT); Trace_Armed = 0; } }while(0)
+// Stamp TRACE_DECIDE and wait for the next register write
+#define TRACE_DECIDE_POINT() do{ TRACE_STAMP(TRACE_DECIDE); Trace_Armed = 1; }while(0)
+
+// Add one measurement of cycles to span
+void Trace_Record(uint8_t span, uint32_t cycles);
+
+// Copy all spans to out[TRACE_SPANS] and clear them
+void Trace_Dump(TraceStat *out);
+
+// Append an event to the ring, overwriting the oldest
+// Trace_Events[(Trace_EventCount-1)%TRACE_LOG_SIZE] is the newest.
+void Trace_Log(uint8_t code, uint8_t a, uint8_t b, uint8_t c);
+#define TRACE_LOG(code,a,b,c) Trace_Log(code,a,b,c)
+extern TraceEvent Trace_Events[TRACE_LOG_SIZE];
+extern uint32_t Trace_EventCount;
+
+#else
+#define TRACE_LOG(code,a,b,c)
+#define TRACE_STAMP(point)
+#define TRACE_COMMIT_POINT()
+#define TRACE_DECIDE_POINT()
+#endif
+
+#endif
@@ -0,0 +1,30 @@
+// Tracker.c
+// Runs on TM4C123, and on a host PC for testing
+// Fixed-point alpha-beta tracker, see Tracker.h.
+
+#include <stdint.h>
+#include "Tracker.h"
+
+void Tracker_Reset(Tracker *t){
+  t->x = 0;
+  t->v = 0;
+  t->primed = 0;
+}
+
+void Tracker_Update(Tracker *t, int32_t z){
+  int32_t r;
+  if (!t->primed){                  // no history: start at rest on the measurement
+    t->x = z*TRACKER_ONE;
+    t->v = 0;
+    t->primed = 1;
+    return;
+  }
+  t->x += t->v;
+  r = z*TRACKER_ONE - t->x;
+  t->x += (int32_t)(((int64_t)r*t->g->alpha)/TRACKER_GAIN_ONE);
+  t->v += (int32_t)(((int64_t)r*t->g->beta)/TRACKER_GAIN_ONE);
+}
+
+int32_t Tracker_Predict(const Tracker *t, int32_t steps){
+  return (t->x + t->v*steps)/TRACKER_ONE;
+}
@@ -0,0 +1,42 @@
+// Tracker.h
+// Runs on TM4C123, and on a host PC for testing
+// Fixed-point alpha-beta tracker: a constant-velocity model of one
+// measured quantity with fixed gains, the steady-state form of a
+// two-state Kalman filter.
+// Each step predicts x += v, then corrects by the residual
+// r = z - x: x += alpha*r, v += beta*r. Larger gains follow changes
+// faster, smaller ones reject more noise.
+// Tracker_Predict() extrapolates the estimate a number of steps ahead,
+// to make up for delay between the quantity and its measurement.
+// host/track.c checks it and runs it in the object follower's loop.
+
+#ifndef TRACKER_H
+#define TRACKER_H
+#include <stdint.h>
+
+#define TRACKER_ONE 256             // 1.0 in the Q8 state
+#define TRACKER_GAIN_ONE 4096       // 1.0 in the Q12 gains
+
+typedef struct {
+  uint16_t alpha, beta;             // Q12, 0 < beta < alpha <= TRACKER_GAIN_ONE
+} TrackerGains;
+
+// Bind the gains with a static initializer, e.g.
+// static Tracker RangeTrack = {&RangeTrackGains}; the rest starts cleared.
+typedef struct {
+  const TrackerGains *g;
+  int32_t x;                        // Q8 estimate
+  int32_t v;                        // Q8 change per step
+  uint8_t primed;                   // x is valid
+} Tracker;
+
+// Forget the estimate, the next measurement restarts it at rest
+void Tracker_Reset(Tracker *t);
+
+// One step with measurement z
+void Tracker_Update(Tracker *t, int32_t z);
+
+// Estimate steps ahead of the last update, 0 for the filtered value
+int32_t Tracker_Predict(const Tracker *t, int32_t steps);
+
+#endif
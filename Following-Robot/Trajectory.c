@@ -0,0 +1,100 @@
+// Trajectory.c
+// Runs on TM4C123
+// Queue of timed motion segments executed from the SysTick ISR.
+// When the last segment ends and the queue is empty the wheels brake.
+
+#include <stdint.h>
+#include "Trajectory.h"
+#include "FIFO.h"
+#include "Motors.h"
+#include "SysTickInts.h"
+
+AddIndexFifo(Traj, TRAJ_FIFO_SIZE, Segment, 1, 0)
+
+static volatile uint8_t Playing;       // 1 while Current is being played
+static volatile uint8_t FlushRequest;  // set by Trajectory_Clear, handled in the ISR
+static Segment Current;
+static uint32_t Elapsed;               // ticks into Current
+static int16_t FromL, FromR;           // command when Current started
+static int16_t CmdL, CmdR;             // last command written to the motors
+static uint8_t Stopped;                // 1 when the wheels were braked after the last segment
+
+#define CMD_UNKNOWN (-32768)           // forces the next Command() to write the motors
+
+void Trajectory_Init(void){
+  TrajFifo_Init();
+  Playing = 0;
+  FlushRequest = 0;
+  Stopped = 1;
+}
+
+int Trajectory_Push(int16_t left, int16_t right, uint16_t duration_ms, uint16_t ramp_ms){
+  Segment seg;
+  seg.left = left;
+  seg.right = right;
+  seg.duration_ms = duration_ms;
+  seg.ramp_ms = (ramp_ms > duration_ms) ? duration_ms : ramp_ms;
+  return TrajFifo_Put(seg);
+}
+
+// The consumer owns GetI, so the flush itself happens in the ISR
+void Trajectory_Clear(void){
+  FlushRequest = 1;
+}
+
+uint8_t Trajectory_Busy(void){
+  return Playing || TrajFifo_Size() || FlushRequest;
+}
+
+static void Command(int16_t left, int16_t right){
+  if ((left != CmdL)||(right != CmdR)){  // no bus writes while holding a speed
+    CmdL = left;
+    CmdR = right;
+    Set_Wheels(left, right);
+  }
+}
+
+void Trajectory_Tick(void){
+  uint32_t ramp;
+  Segment discard;
+  if (FlushRequest){
+    while(TrajFifo_Get(&discard)){};
+    if (Playing){
+      Playing = 0;
+      Stopped = 1;
+      Stop_Both_Wheels_Mode(STOP_BRAKE);
+    }
+    FlushRequest = 0;
+    return;
+  }
+  if (!Playing){
+    if (!TrajFifo_Get(&Current)){
+      return;                            // idle, the motors belong to someone else
+    }
+    Playing = 1;
+    Elapsed = 0;
+    if (Stopped){                        // someone else may have moved the motors since
+      Stopped = 0;
+      CmdL = CmdR = CMD_UNKNOWN;
+      FromL = FromR = 0;
+    }else{
+      FromL = CmdL;                      // continue from the previous segment
+      FromR = CmdR;
+    }
+  }
+  Elapsed++;
+  ramp = MS_TO_TICKS(Current.ramp_ms);
+  if (Elapsed < ramp){
+    Command(FromL + ((int32_t)(Current.left - FromL)*(int32_t)Elapsed)/(int32_t)ramp, // signed divide
+            FromR + ((int32_t)(Current.right - FromR)*(int32_t)Elapsed)/(int32_t)ramp);
+  }else{
+    Command(Current.left, Current.right);
+  }
+  if (Elapsed >= MS_TO_TICKS(Current.duration_ms)){
+    Playing = 0;
+    if (TrajFifo_Size() == 0){
+      Stopped = 1;
+      Stop_Both_Wheels_Mode(STOP_BRAKE);
+    }
+  }
+}
@@ -0,0 +1,39 @@
+// Trajectory.h
+// Runs on TM4C123
+// Queue of timed motion segments executed from the SysTick ISR.
+// The main loop pushes segments; Trajectory_Tick() plays them back at
+// TICK_HZ, so actuation timing does not depend on how long the main
+// loop takes. The queue is a lock-free single producer/single consumer
+// FIFO (FIFO.h): only the main loop may call Trajectory_Push and
+// Trajectory_Clear, only the ISR calls Trajectory_Tick.
+// While Trajectory_Busy() nothing else may drive the motors.
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+#include <stdint.h>
+
+#define TRAJ_FIFO_SIZE 16   // segments, power of 2
+
+typedef struct {
+  int16_t left;             // signed duty at the end of the ramp, see Set_Wheels()
+  int16_t right;
+  uint16_t duration_ms;     // total segment time, including the ramp
+  uint16_t ramp_ms;         // linear ramp from the previous command, 0 = step
+} Segment;
+
+void Trajectory_Init(void);
+
+// Queue a segment
+// Output: 1 if queued, 0 if the queue is full
+int Trajectory_Push(int16_t left, int16_t right, uint16_t duration_ms, uint16_t ramp_ms);
+
+// Drop all queued segments and brake at the next tick
+void Trajectory_Clear(void);
+
+// 1 while a segment is playing or queued
+uint8_t Trajectory_Busy(void);
+
+// Segment player, call from the SysTick ISR
+void Trajectory_Tick(void);
+
+#endif
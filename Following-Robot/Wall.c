@@ -0,0 +1,49 @@
+// Wall.c
+// Runs on TM4C123, and on a host PC for testing
+// PD wall follower, see Wall.h.
+
+#include <stdint.h>
+#include "Wall.h"
+#include "Pid.h"
+#include "Motors.h"
+#include "ADC0SS2.h"
+
+// Side error in ADC counts -> differential duty, positive steers in
+static const PidGains SideGains =
+  //  kp  ki     kd  d_alpha  out_min    out_max
+  { 1200,  0, 10000, 64, -SPEED_35, SPEED_35};
+
+static Pid Side = {&SideGains};
+
+void Wall_Reset(void){
+  Pid_Reset(&Side);
+}
+
+// 0 below WALL_SLOW_DIST up to 256 at WALL_DIST
+static int32_t Corner_Q8(uint16_t ahead){
+  if (ahead <= WALL_SLOW_DIST){
+    return 0;
+  }
+  if (ahead >= WALL_DIST){
+    return 256;
+  }
+  return ((int32_t)(ahead - WALL_SLOW_DIST)*256)/(WALL_DIST - WALL_SLOW_DIST);
+}
+
+static int16_t Clamp_Duty(int32_t duty){
+  if (duty > SPEED_98){
+    return SPEED_98;
+  }
+  if (duty < -SPEED_35){
+    return -SPEED_35;
+  }
+  return (int16_t)duty;
+}
+
+void Wall_Step(uint16_t ahead, uint16_t side, int16_t *duty_in, int16_t *duty_out){
+  int32_t corner = Corner_Q8(ahead);
+  int32_t v = WALL_SPEED - ((WALL_SPEED - SPEED_35)*corner)/256;
+  int32_t w = Pid_Update(&Side, WALL_DIST, side) - (SPEED_35*corner)/256; // wall far: w > 0
+  *duty_in = Clamp_Duty(v + w);
+  *duty_out = Clamp_Duty(v - w);
+}
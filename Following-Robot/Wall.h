@@ -0,0 +1,41 @@
+// Wall.h
+// Runs on TM4C123, and on a host PC for testing
+// Wall follower for modes 2 and 3.
+// WALL_PD: a PD loop holds the side IR reading at WALL_DIST while both
+// wheels cruise at WALL_SPEED. As the front reading rises past
+// WALL_SLOW_DIST the cruise speed drops towards SPEED_35 and a bias
+// turns the robot away from the wall, so most inside corners are
+// taken as a curve; a wall closer than WALL_DIST ahead still gets the
+// pivot from Behavior.c.
+// WALL_BANGBANG: the original Move_Left_Forward/Move_Right_Forward and
+// Move_Forward logic, kept for comparison.
+// Outputs are named for the wheel that closes in on the wall when it
+// runs faster: the left wheel in mode 2 (as in Move_Left_Forward),
+// the right wheel in mode 3.
+// host/wall.c runs laps of a simulated room with both controllers. With
+// the side sensor at 45 degrees PD laps in 14.71 s holding the wall to
+// 12 mm rms (bang-bang 22.48 s, 109 mm); at 60 degrees 14.46 s and
+// 27 mm (19.27 s, 85 mm). Neither is tuned on the robot.
+
+#ifndef WALL_H
+#define WALL_H
+#include <stdint.h>
+
+#define WALL_BANGBANG 0
+#define WALL_PD       1
+#ifndef WALL_CONTROLLER
+#define WALL_CONTROLLER WALL_PD
+#endif
+
+#define WALL_SPEED     SPEED_80     // cruise duty on a straight wall
+#define WALL_SLOW_DIST 700          // front reading where corner slow-down begins
+
+// Forget the loop state, e.g. after a pivot
+void Wall_Reset(void);
+
+// One control step from the front and wall-side IR readings
+// Output: signed duties for the wheel that steers in towards the wall
+// and for the other one
+void Wall_Step(uint16_t ahead, uint16_t side, int16_t *duty_in, int16_t *duty_out);
+
+#endif
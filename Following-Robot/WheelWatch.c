@@ -0,0 +1,48 @@
+// WheelWatch.c
+// Runs on TM4C123, and on a host PC for testing
+// Window arithmetic of the stall check.
+
+#include <stdint.h>
+#include "WheelWatch.h"
+#include "Stall.h"
+#include "Motors.h"
+#include "SysTickInts.h"
+
+void WheelWatch_Reset(WheelWatch *w, int32_t counts){
+  w->last = counts;
+  w->travel = 0;
+  w->ticks = 0;
+  w->driven = 0;
+  w->duty = 0;
+  w->bad = 0;
+}
+
+void WheelWatch_Sample(WheelWatch *w, int32_t counts, uint8_t on, uint32_t duty){
+  int32_t step = counts - w->last;
+  w->last = counts;
+  w->travel += (step < 0) ? -step : step;
+  w->ticks++;
+  if (on && (duty >= STALL_MIN_DUTY)){
+    w->driven++;
+    w->duty += duty;
+  }
+}
+
+uint8_t WheelWatch_End(WheelWatch *w){
+  if (w->ticks && (w->driven == w->ticks)){   // driven on every tick
+    // counts a free wheel makes at the summed duty, 64-bit: up to 100*PERIOD*STALL_MAX_CPS
+    uint32_t expected = (uint32_t)(((uint64_t)w->duty*STALL_MAX_CPS)/((uint64_t)PERIOD*TICK_HZ));
+    if (w->travel*100 < expected*STALL_FRACTION_PCT){
+      w->bad++;
+    }else{
+      w->bad = 0;
+    }
+  }else{
+    w->bad = 0;           // spin-up, stops and deadband duties are never judged
+  }
+  w->travel = 0;
+  w->ticks = 0;
+  w->driven = 0;
+  w->duty = 0;
+  return w->bad >= STALL_WINDOWS;
+}
@@ -0,0 +1,35 @@
+// WheelWatch.h
+// Runs on TM4C123, and on a host PC for testing
+// Window arithmetic of the stall check, kept apart from the PWM
+// registers in Stall.c so it can be checked on a host (host/stall.c).
+// WheelWatch_Sample() is called every tick with the wheel's encoder
+// count, enable and duty; it adds up the travel, the ticks the wheel was
+// driven at STALL_MIN_DUTY or more, and the duty of those ticks.
+// WheelWatch_End() closes a window: a wheel driven on every tick of it
+// must have made STALL_FRACTION_PCT of the travel its summed duty gives
+// on a free wheel, or the window counts as bad.
+
+#ifndef WHEELWATCH_H
+#define WHEELWATCH_H
+#include <stdint.h>
+
+typedef struct {
+  int32_t last;           // encoder count at the previous sample
+  uint32_t travel;        // counts moved this window, either way
+  uint32_t ticks;         // samples this window
+  uint32_t driven;        // samples enabled at STALL_MIN_DUTY or more
+  uint32_t duty;          // sum of the duty of the driven samples
+  uint8_t bad;            // consecutive bad windows
+} WheelWatch;
+
+// Start watching from encoder count counts
+void WheelWatch_Reset(WheelWatch *w, int32_t counts);
+
+// One tick; duty in PWM counts, as read back from the compare register
+void WheelWatch_Sample(WheelWatch *w, int32_t counts, uint8_t on, uint32_t duty);
+
+// Close the window and start the next one
+// Output: 1 if the last STALL_WINDOWS windows were all bad
+uint8_t WheelWatch_End(WheelWatch *w);
+
+#endif
@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+# gen_steer_lut.py
+# Generates SteerLut.c, the cell table for SteerLut.h, from the
+# thresholds in ADC0SS2.h, then checks it for every 12-bit reading.
+# Usage: python gen_steer_lut.py   (from the project directory)
+
+import re
+import sys
+
+BRAKE, BACKOFF, FOLLOW, R, L, IN, PIVOT, AHEAD = 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80
+BINS = 6
+POLICIES = ("STEER_POLICY_FOLLOW", "STEER_POLICY_WALL_LEFT", "STEER_POLICY_WALL_RIGHT")
+
+
+def thresholds():
+    text = open("ADC0SS2.h").read()
+    t = {}
+    for name in ("FOLLOW_DIST", "STOP_DIST", "WALL_DIST"):
+        t[name] = int(re.search(r"#define\s+%s\s+(\d+)" % name, text).group(1))
+    return t
+
+
+def steer_bin(v, t):
+    # must match STEER_BIN() in SteerLut.h; host/steerlut.c checks the
+    # generated table with the real macro
+    return ((v >= t["WALL_DIST"]) + (v > t["WALL_DIST"]) + (v >= t["FOLLOW_DIST"])
+            + (v > t["FOLLOW_DIST"] + 200) + (v > t["STOP_DIST"]))
+
+
+# Reference models: the bang-bang branches of Steer.c, one command per reading
+def follow(ahead, left, right, t):
+    cmd = 0
+    if ahead > t["STOP_DIST"] or left > t["STOP_DIST"] or right > t["STOP_DIST"]:
+        cmd |= BRAKE
+        if ahead > t["FOLLOW_DIST"] + 200:
+            return cmd | BACKOFF
+    if ahead < t["FOLLOW_DIST"]:
+        cmd |= FOLLOW
+        if left < t["FOLLOW_DIST"]:
+            cmd |= R
+        if right < t["FOLLOW_DIST"]:
+            cmd |= L
+    return cmd
+
+
+def wall(ahead, side, t):
+    if side < t["WALL_DIST"]:
+        return IN
+    if ahead > t["WALL_DIST"]:
+        return PIVOT
+    return AHEAD
+
+
+def model(policy, ahead, left, right, t):
+    if policy == 0:
+        return follow(ahead, left, right, t)
+    return wall(ahead, left if policy == 1 else right, t)
+
+
+def build(t):
+    # one representative reading per bin
+    rep = {}
+    for v in range(4096):
+        rep.setdefault(steer_bin(v, t), v)
+    if len(rep) != BINS:
+        sys.exit("thresholds leave a bin empty: %s" % t)
+    return [[model(p, rep[a], rep[l], rep[r], t)
+             for a in range(BINS) for l in range(BINS) for r in range(BINS)]
+            for p in range(len(POLICIES))]
+
+
+def verify(table, t):
+    # A command depends on each reading only through per-axis comparisons,
+    # so it is enough that every reading agrees with its bin's representative
+    # on each axis while the other two are held at every representative.
+    rep = {}
+    for v in range(4096):
+        rep.setdefault(steer_bin(v, t), v)
+    for p in range(len(POLICIES)):
+        for axis in range(3):
+            for v in range(4096):
+                b = steer_bin(v, t)
+                for x in range(BINS):
+                    for y in range(BINS):
+                        cell = [x, y]
+                        cell.insert(axis, b)
+                        reading = [rep[c] for c in cell]
+                        reading[axis] = v
+                        want = model(p, reading[0], reading[1], reading[2], t)
+                        got = table[p][(cell[0]*BINS + cell[1])*BINS + cell[2]]
+                        if want != got:
+                            sys.exit("mismatch: policy %d readings %s" % (p, reading))
+
+
+def emit(table, t):
+    out = []
+    out.append("// SteerLut.c")
+    out.append("// Generated by gen_steer_lut.py from ADC0SS2.h, do not edit.")
+    out.append("// Cell table for SteerLut.h, index [policy][STEER_CELL(ahead,left,right)].")
+    out.append("")
+    out.append("#include <stdint.h>")
+    out.append('#include "SteerLut.h"')
+    out.append('#include "ADC0SS2.h"')
+    out.append("")
+    out.append("#if (WALL_DIST != %d)||(FOLLOW_DIST != %d)||(STOP_DIST != %d)"
+               % (t["WALL_DIST"], t["FOLLOW_DIST"], t["STOP_DIST"]))
+    out.append('#error "SteerLut.c is out of date, rerun gen_steer_lut.py"')
+    out.append("#endif")
+    out.append("")
+    out.append("const uint8_t SteerLut[STEER_POLICIES][STEER_CELLS] = {")
+    for p, name in enumerate(POLICIES):
+        out.append("  { // %s" % name)
+        row = table[p]
+        for a in range(BINS):
+            cells = row[a*BINS*BINS:(a+1)*BINS*BINS]
+            for i in range(0, len(cells), 12):
+                out.append("    " + ",".join("0x%02X" % c for c in cells[i:i+12]) + ",")
+        out.append("  },")
+    out.append("};")
+    return "\n".join(out) + "\n"
+
+
+def main():
+    t = thresholds()
+    table = build(t)
+    verify(table, t)
+    with open("SteerLut.c", "w") as f:
+        f.write(emit(table, t))
+    print("SteerLut.c: %d bytes of table, verified for all 12-bit readings"
+          % (len(POLICIES)*BINS**3))
+
+
+if __name__ == "__main__":
+    main()
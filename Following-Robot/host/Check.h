@@ -0,0 +1,23 @@
+// Check.h
+// Runs on a host PC
+// Minimal assertions for the host checks: a failed CHECK prints where
+// and what, and CHECK_DONE makes main return non-zero so make stops.
+
+#ifndef CHECK_H
+#define CHECK_H
+#include <stdio.h>
+
+static int Check_Fails;
+
+#define CHECK(cond) do{ \
+  if (!(cond)){ \
+    printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+    Check_Fails++; \
+  } \
+}while(0)
+
+#define CHECK_DONE(name) ( \
+  printf("%s: %s\n", (name), Check_Fails ? "FAILED" : "ok"), \
+  (Check_Fails != 0))
+
+#endif
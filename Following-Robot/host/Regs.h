@@ -0,0 +1,12 @@
+// Regs.h
+// Runs on a host PC
+// Stand-ins for the port registers that a host-built module writes.
+// Forced into those builds with -include, together with
+// -DDIRECTION=Host_Direction, so Motors.h leaves DIRECTION alone.
+
+#ifndef REGS_H
+#define REGS_H
+
+extern unsigned long Host_Direction;
+
+#endif
@@ -0,0 +1,54 @@
+// Sim.h
+// Runs on a host PC
+// Shared pieces of the robot models in the host simulations.
+// Sim_IR() is the Sharp sensor as the controllers were tuned against
+// it: 285000/d counts for d mm, clipped to the sensor's range, plus
+// uniform noise of +/-30 counts. The noise comes from a fixed-seed
+// generator, so every run of a simulation gives the same numbers.
+// A wheel at duty u runs towards SIM_VMAX*u/PERIOD mm/s with a
+// first-order lag of SIM_TAU s.
+
+#ifndef SIM_H
+#define SIM_H
+#include <stdint.h>
+#include <math.h>
+
+#ifndef M_PI                        // not in strict C99
+#define M_PI 3.14159265358979323846
+#endif
+
+#define SIM_VMAX  500.0             // mm/s at full duty
+#define SIM_TAU   0.08              // s, wheel speed lag
+#define SIM_TRACK 141.0             // mm between the wheels
+
+static uint32_t Sim_Seed = 1;
+
+// Uniform in -amp..amp
+static inline int32_t Sim_Noise(int32_t amp){
+  Sim_Seed = Sim_Seed*1664525 + 1013904223;
+  return (int32_t)((Sim_Seed>>8)%(2*amp + 1)) - amp;
+}
+
+// Gaussian with standard deviation sigma (Box-Muller)
+static inline double Sim_Gauss(double sigma){
+  double u, v;
+  Sim_Seed = Sim_Seed*1664525 + 1013904223;
+  u = ((Sim_Seed>>8) + 1.0)/16777218.0;   // 0 < u < 1
+  Sim_Seed = Sim_Seed*1664525 + 1013904223;
+  v = ((Sim_Seed>>8) + 1.0)/16777218.0;
+  return sigma*sqrt(-2*log(u))*cos(2*M_PI*v);
+}
+
+// Reading for an object d mm away, noise included
+static inline uint16_t Sim_IR(double d){
+  double a = 285000.0/d;
+  if (a > 4095){
+    a = 4095;
+  }
+  if (a < 300){
+    a = 300;
+  }
+  return (uint16_t)(a + Sim_Noise(30));
+}
+
+#endif
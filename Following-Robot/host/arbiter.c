@@ -0,0 +1,136 @@
+// arbiter.c
+// Runs on a host PC
+// Checks Arbiter.c with scripted layers and a simulated time source:
+// Now stands in for the cycle counter, each layer advances it by its
+// cost and proposes whatever the test has set for it.
+
+#include <stdint.h>
+#include <string.h>
+#include "Check.h"
+#include "Arbiter.h"
+
+#define LAYERS 4
+
+static uint32_t Now;
+static uint32_t Cycles(void){
+  return Now;
+}
+
+static uint8_t Want[LAYERS];        // kind each layer proposes
+static uint32_t Cost[LAYERS];       // time units each run takes
+static uint32_t Released[LAYERS];   // release hook calls
+
+static void Propose(uint8_t i, MotionCmd *cmd){
+  Now += Cost[i];
+  cmd->kind = Want[i];
+  cmd->arg = i;
+}
+static void P0(const SensorFrame *ir, MotionCmd *cmd){ Propose(0, cmd); }
+static void P1(const SensorFrame *ir, MotionCmd *cmd){ Propose(1, cmd); }
+static void P2(const SensorFrame *ir, MotionCmd *cmd){ Propose(2, cmd); }
+static void P3(const SensorFrame *ir, MotionCmd *cmd){ Propose(3, cmd); }
+static void R0(void){ Released[0]++; }
+static void R2(void){ Released[2]++; }
+static void R3(void){ Released[3]++; }
+
+static const Layer Table[LAYERS] = {
+  {P0, R0, 100},
+  {P1, 0, 100},                     // no release hook
+  {P2, R2, 400},
+  {P3, R3, 400},
+};
+
+int main(void){
+  SensorFrame ir;
+  MotionCmd cmd;
+  uint8_t i;
+  memset(&ir, 0, sizeof(ir));
+  // priority order: the highest proposing layer wins, the rest are
+  // suppressed and not run; disabled layers are neither
+  {
+    Arbiter_Init(Table, LAYERS, Cycles);
+    Want[0] = CMD_NONE; Want[1] = CMD_NONE; Want[2] = CMD_WHEELS; Want[3] = CMD_BRAKE;
+    CHECK(Arbiter_Step(&ir, 0x0F, &cmd) == 2);
+    CHECK((cmd.kind == CMD_WHEELS)&&(cmd.arg == 2));
+    CHECK(Arbiter_Stats(0)->runs == 1);
+    CHECK(Arbiter_Stats(2)->wins == 1);
+    CHECK(Arbiter_Stats(3)->runs == 0);
+    CHECK(Arbiter_Stats(3)->suppressed == 1);
+    Want[0] = CMD_BRAKE;
+    CHECK(Arbiter_Step(&ir, 0x0F, &cmd) == 0);
+    CHECK(cmd.kind == CMD_BRAKE);
+    CHECK(Arbiter_Stats(1)->suppressed == 1);
+    CHECK(Arbiter_Stats(2)->suppressed == 1);
+    CHECK(Arbiter_Stats(3)->suppressed == 2);
+    CHECK(Arbiter_Step(&ir, 0x0C, &cmd) == 2); // layers 0 and 1 disabled
+    CHECK(Arbiter_Stats(0)->runs == 2);
+    CHECK(Arbiter_Stats(1)->runs == 1);
+    CHECK(Arbiter_Stats(1)->suppressed == 1);
+    CHECK(Arbiter_Stats(3)->suppressed == 3);
+    Want[2] = Want[3] = CMD_NONE;
+    CHECK(Arbiter_Step(&ir, 0x0C, &cmd) == ARB_NONE);
+    CHECK(cmd.kind == CMD_NONE);
+    for(i=0; i<LAYERS; i++){        // runs + suppressed = ticks enabled
+      CHECK(Arbiter_Stats(i)->runs + Arbiter_Stats(i)->suppressed == ((i < 2) ? 2 : 4));
+    }
+  }
+  // release-on-loss: once when a layer loses the motors, never while it
+  // keeps them, not for a layer without a hook, not after a reset
+  {
+    memset(Released, 0, sizeof(Released));
+    Arbiter_Init(Table, LAYERS, Cycles);
+    Want[0] = Want[1] = Want[2] = CMD_NONE;
+    Want[3] = CMD_WHEELS;
+    Arbiter_Step(&ir, 0x0F, &cmd);
+    Arbiter_Step(&ir, 0x0F, &cmd);
+    CHECK(Released[3] == 0);        // kept the motors
+    Want[2] = CMD_WHEELS;
+    Arbiter_Step(&ir, 0x0F, &cmd);
+    CHECK(Released[3] == 1);        // 2 took over
+    Want[1] = CMD_HOLD;
+    Arbiter_Step(&ir, 0x0F, &cmd);
+    CHECK(Released[2] == 1);
+    Want[1] = CMD_NONE;
+    Arbiter_Step(&ir, 0x0F, &cmd);  // 1 has no hook, 2 wins again
+    CHECK(Released[2] == 1);
+    Want[2] = CMD_NONE;
+    Want[3] = CMD_NONE;
+    CHECK(Arbiter_Step(&ir, 0x0F, &cmd) == ARB_NONE);
+    CHECK(Released[2] == 2);        // nobody drives: released too
+    Arbiter_Step(&ir, 0x0F, &cmd);
+    CHECK(Released[2] == 2);
+    Want[3] = CMD_WHEELS;
+    Arbiter_Step(&ir, 0x0F, &cmd);
+    Arbiter_Reset();                // motors stopped by someone else
+    Want[0] = CMD_BRAKE;
+    Arbiter_Step(&ir, 0x0F, &cmd);
+    CHECK(Released[3] == 1);        // no hook after a reset
+    CHECK(Released[0] == 0);
+  }
+  // overruns and worst-case time from the time source
+  {
+    Arbiter_Init(Table, LAYERS, Cycles);
+    Want[0] = Want[1] = Want[2] = CMD_NONE;
+    Want[3] = CMD_WHEELS;
+    Cost[0] = 50; Cost[1] = 100; Cost[2] = 399; Cost[3] = 250;
+    Arbiter_Step(&ir, 0x0F, &cmd);
+    Cost[0] = 101; Cost[1] = 60; Cost[2] = 401; Cost[3] = 800;
+    Arbiter_Step(&ir, 0x0F, &cmd);
+    Cost[0] = 70; Cost[1] = 200; Cost[2] = 300; Cost[3] = 100;
+    Arbiter_Step(&ir, 0x0F, &cmd);
+    CHECK(Arbiter_Stats(0)->overruns == 1);  // 101 > 100
+    CHECK(Arbiter_Stats(1)->overruns == 1);  // 100 is within its budget, 200 is not
+    CHECK(Arbiter_Stats(2)->overruns == 1);
+    CHECK(Arbiter_Stats(3)->overruns == 1);
+    CHECK(Arbiter_Stats(0)->wcet == 101);
+    CHECK(Arbiter_Stats(1)->wcet == 200);
+    CHECK(Arbiter_Stats(2)->wcet == 401);
+    CHECK(Arbiter_Stats(3)->wcet == 800);
+    Want[0] = CMD_BRAKE;            // a suppressed layer costs nothing
+    Cost[3] = 5000;
+    Arbiter_Step(&ir, 0x0F, &cmd);
+    CHECK(Arbiter_Stats(3)->wcet == 800);
+    CHECK(Arbiter_Stats(3)->overruns == 1);
+  }
+  return CHECK_DONE("arbiter");
+}
@@ -0,0 +1,126 @@
+// follow.c
+// Runs on a host PC
+// Closed-loop simulation of Follow.c against a simple robot model.
+// The target sits straight ahead, d mm away, read through Sim_IR().
+// The wheel speed lags the duty by SIM_TAU, 30 ms when braking. The
+// controller runs every 2 ms (CONTROL_HZ = 500), the model every 1 ms.
+// Step responses from several starting distances must settle inside
+// 5% of the set point without large overshoot. A target that drives
+// away at 100 mm/s must be tracked with a small lag.
+// The same runs are made with the original bang-bang decisions
+// (Steer_Decide(), FOLLOW_CONTROLLER=FOLLOW_BANGBANG without STEER_HYST)
+// as the baseline: both wheels at SPEED_35 while the reading is below
+// FOLLOW_DIST, braked (the PWM disabled) when told to stop, left alone
+// in between, and the BACKOFF_MS reverse past STOP_DIST, during which
+// no decisions are made.
+// Build with EXTRA=-DFOLLOW_GAINS=0 or 2 to try the other gain sets.
+
+#include <stdint.h>
+#include <math.h>
+#include "Check.h"
+#include "Sim.h"
+#include "Follow.h"
+#include "Steer.h"
+#include "Behavior.h"
+#include "Motors.h"
+#include "ADC0SS2.h"
+
+#define SIM_MS  10000
+
+typedef struct {
+  double final;                     // distance at the end, mm
+  double overshoot;                 // worst excursion past the set point, % of it
+  int settle;                       // ms until it stays inside 5% of the set point
+  double lag;                       // distance behind a moving target, mm
+} Result;
+
+#define PID  0
+#define BANG 1
+
+// Bang-bang duty for one control step, both wheels alike: the side
+// readings are fed in equal
+static double Bang_Step(uint16_t ahead, double duty, int *backoff){
+  uint8_t cmd = Steer_Decide(STEER_POLICY_FOLLOW, ahead, ahead*6/10, ahead*6/10);
+  if (cmd&STEER_BRAKE){
+    duty = 0;
+  }
+  if (cmd&STEER_BACKOFF){
+    *backoff = BACKOFF_MS;
+    return 0;
+  }
+  if (cmd&STEER_FOLLOW){
+    duty = (((cmd&STEER_L) ? SPEED_35 : 0) + ((cmd&STEER_R) ? SPEED_35 : 0))/2.0;
+  }
+  return duty;
+}
+
+// move: target drives away at 100 mm/s from 5 s to 8 s
+static Result Run(double d0, int move, int ctl){
+  Result r = {0, 0, 0, 0};
+  double sp = 285000.0/FOLLOW_DIST, d = d0, v = 0, duty = 0, worst = 0;
+  int ms, backoff = 0;
+  Follow_Reset();
+  for(ms=0; ms<SIM_MS; ms++){
+    uint16_t ahead = Sim_IR(d);
+    if (move && (ms >= 5000)&&(ms < 8000)){
+      d += 0.1;
+    }
+    if (move && (ms == 7999)){
+      r.lag = d - sp;
+    }
+    if (backoff){                   // the queued reverse, braked at its end
+      backoff--;
+      duty = (backoff == 0) ? 0 :
+             -SPEED_35*((BACKOFF_MS - backoff < BACKOFF_RAMP_MS) ? (BACKOFF_MS - backoff)/(double)BACKOFF_RAMP_MS : 1);
+    }else if ((ms%2) == 0){
+      if (ctl == PID){
+        int16_t l, rt;
+        Follow_Step(ahead, ahead*6/10, ahead*6/10, &l, &rt);
+        duty = (l + rt)/2.0;
+      }else{
+        duty = Bang_Step(ahead, duty, &backoff);
+      }
+    }
+    v += (SIM_VMAX*duty/PERIOD - v)*0.001/((duty == 0) ? 0.03 : SIM_TAU);
+    d -= v*0.001;
+    if (ms < 5000){
+      double past = (d0 > sp) ? sp - d : d - sp;
+      if (past > worst){
+        worst = past;
+      }
+      if (fabs(d - sp) > 0.05*sp){
+        r.settle = ms + 1;
+      }
+    }
+  }
+  r.final = d;
+  r.overshoot = 100*worst/sp;
+  return r;
+}
+
+int main(void){
+  static const double starts[] = {60, 80, 150, 200, 300};
+  double sp = 285000.0/FOLLOW_DIST;
+  unsigned i;
+  printf("set point %.1f mm\n", sp);
+  for(i=0; i<sizeof(starts)/sizeof(starts[0]); i++){
+    Result r = Run(starts[i], 0, PID), b = Run(starts[i], 0, BANG);
+    printf("from %3.0f mm: PID final %.1f mm, overshoot %.1f%%, settled in %d ms;"
+           " bang-bang %.1f mm, %.1f%%, ",
+           starts[i], r.final, r.overshoot, r.settle, b.final, b.overshoot);
+    if (b.settle >= 5000){
+      printf("never settled\n");
+    }else{
+      printf("%d ms\n", b.settle);
+    }
+    CHECK(fabs(r.final - sp) < 0.02*sp);
+    CHECK(r.overshoot < 10);
+    CHECK(r.settle < 1500);
+  }
+  {
+    Result r = Run(150, 1, PID), b = Run(150, 1, BANG);
+    printf("moving target: %.1f mm behind at 100 mm/s, bang-bang %.1f mm\n", r.lag, b.lag);
+    CHECK(r.lag < 15);
+  }
+  return CHECK_DONE("follow");
+}
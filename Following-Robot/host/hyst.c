@@ -0,0 +1,109 @@
+// hyst.c
+// Runs on a host PC
+// Checks Hyst.c, then replays synthetic 500 Hz IR traces through it and
+// counts output changes per second against a plain compare.
+// There are no recorded robot traces, so the traces are synthetic:
+//   hover   the reading sits at the threshold with Gaussian noise
+//   spikes  as hover, plus 2% samples off by +/-120 counts
+//   sweep   a slow +/-200 count triangle through the threshold, 0.5
+//           true crossings per second
+// The bands are the steering ones from Behavior.h.
+
+#include <stdint.h>
+#include "Check.h"
+#include "Sim.h"
+#include "Hyst.h"
+#include "ADC0SS2.h"
+#include "Behavior.h"
+#include "SysTickInts.h"
+
+#define HZ    500
+#define SECS  20
+#define N     (HZ*SECS)
+
+#define TR_HOVER  0
+#define TR_SPIKES 1
+#define TR_SWEEP  2
+static const char *TraceName[] = {"hover", "spikes", "sweep"};
+
+static uint16_t Trace[N];
+
+static void Make_Trace(int kind, uint16_t thr, double sigma){
+  int i;
+  for(i=0; i<N; i++){
+    double v = thr, t = (double)i/HZ;
+    if (kind == TR_SWEEP){
+      double p = fmod(t, 4.0);
+      v += 200*((p < 2) ? (p - 1) : (3 - p));
+    }
+    v += Sim_Gauss(sigma);
+    if ((kind == TR_SPIKES)&&(Sim_Noise(24) == 0)){
+      v += (Sim_Noise(1) >= 0) ? 120 : -120;
+    }
+    Trace[i] = (v < 0) ? 0 : (v > 4095) ? 4095 : (uint16_t)v;
+  }
+}
+
+// Output changes per second of a plain v >= thr
+static double Raw_Rate(uint16_t thr){
+  int i, flips = 0;
+  uint8_t out = (Trace[0] >= thr);
+  for(i=1; i<N; i++){
+    uint8_t now = (Trace[i] >= thr);
+    flips += (now != out);
+    out = now;
+  }
+  return flips/(double)SECS;
+}
+
+static double Hyst_Rate(const HystBand *b){
+  Hyst h;
+  int i;
+  Hyst_Init(&h, b);
+  for(i=0; i<N; i++){
+    Hyst_Update(&h, Trace[i], i*TICK_HZ/HZ);  // stamps in ticks, as ir->stamp
+  }
+  return h.flips/(double)SECS;
+}
+
+static void Replay(const char *name, uint16_t thr, uint16_t band, double sigma, double max_hover){
+  HystBand b = {thr + band, thr - band, MS_TO_TICKS(STEER_DWELL_MS)};
+  int kind;
+  for(kind=TR_HOVER; kind<=TR_SWEEP; kind++){
+    double raw, hyst;
+    Make_Trace(kind, thr, sigma);
+    raw = Raw_Rate(thr);
+    hyst = Hyst_Rate(&b);
+    printf("%-11s sigma %2.0f %-6s %6.1f -> %4.1f flips/s\n", name, sigma, TraceName[kind], raw, hyst);
+    CHECK(hyst < raw/10);
+    if (kind == TR_HOVER){
+      CHECK(hyst < max_hover);
+    }
+    if (kind == TR_SWEEP){
+      CHECK(hyst >= 0.45);            // still sees every true crossing
+      CHECK(hyst < 1.0);
+    }
+  }
+}
+
+int main(void){
+  // comparator behaviour
+  {
+    static const HystBand b = {110, 90, 5};
+    Hyst h;
+    Hyst_Init(&h, &b);
+    CHECK(Hyst_Update(&h, 100, 0) == 0); // first update follows the input
+    CHECK(Hyst_Update(&h, 109, 10) == 0);
+    CHECK(Hyst_Update(&h, 110, 20) == 1);
+    CHECK(Hyst_Update(&h, 89, 22) == 1); // below off, but inside the dwell
+    CHECK(Hyst_Update(&h, 90, 30) == 1); // inside the band: holds
+    CHECK(Hyst_Update(&h, 89, 31) == 0);
+    CHECK(h.flips == 2);
+    Hyst_Reset(&h);
+    CHECK(Hyst_Update(&h, 200, 32) == 1); // no dwell after a reset
+    CHECK(h.flips == 2);
+  }
+  Replay("FOLLOW_DIST", FOLLOW_DIST, FOLLOW_HYST, 15, 3);
+  Replay("WALL_DIST", WALL_DIST, WALL_HYST, 10, 3);
+  return CHECK_DONE("hyst");
+}
@@ -0,0 +1,187 @@
+// modesel.c
+// Runs on a host PC
+// Replays scripted scenes through ModeSelect.c, 500 frames a second
+// as Behavior_Step() feeds it, switching whenever it says to as
+// AUTO_MODE does, and counts the switches and how long each took.
+// The scenes are synthetic; the geometry is an assumption, not a
+// measurement. Side sensors look 35 degrees off the heading, each
+// reading is the Sharp output for the nearest surface along its axis
+// (or inside its 12 degree cone, for a person), refreshed every 38 ms
+// with +/-30 counts of noise as Sim_IR().
+//   hallway      following the left wall 140 mm away, +/-15 mm, in a
+//                350 mm hallway: the right wall is in view too
+//   corners      following the left wall at 150 mm/s, with an inside
+//                corner every 3 s: the end wall comes up ahead and the
+//                robot pivots right for 0.5 s to put it on its left
+//   person       following a person 100 to 130 mm ahead, swaying
+//                +/-40 mm at 0.8 Hz, nothing else in view. At the ends
+//                of a sway a side sensor sees them steadily for a few
+//                hundred ms, which looks like a wall on that side.
+//   wall, person following the left wall, a person steps in 250 mm
+//                ahead at 4 s, the wall ends at 6 s
+// Each scene runs 30 s from 5 seeds. Latency is from the wall ending
+// to the switch.
+
+#include <stdint.h>
+#include "Check.h"
+#include "Sim.h"
+#include "ModeSelect.h"
+#include "SysTickInts.h"
+
+#define SIM_MS 30000
+#define SEEDS  5
+#define CONE   (12*M_PI/180)
+#define SIDE   (35*M_PI/180)
+#define FAR    1e9
+
+#define SC_HALLWAY 0
+#define SC_CORNERS 1
+#define SC_PERSON  2
+#define SC_WALLEND 3
+static const char *SceneName[] = {"hallway", "corners", "person", "wall, person"};
+static const char *ModeName[] = {"none", "follow", "wall left", "wall right"};
+
+// Distance along a sensor axis at rad from the heading to the left
+// wall y = w and to the end wall x = f, robot at the origin
+static double Walls(double rad, double w, double f){
+  double d = FAR;
+  if (sin(rad) > 0.01){
+    d = w/sin(rad);
+  }
+  if ((cos(rad) > 0.01)&&(f/cos(rad) < d)){
+    d = f/cos(rad);
+  }
+  return d;
+}
+
+// Distance to a person p mm ahead and y mm to the left, 120 mm wide,
+// if the cone of the sensor at rad from the heading takes them in
+static double Person(double rad, double p, double y){
+  double d = hypot(p, y), b = atan2(y, p) - rad;
+  return (fabs(b) < CONE + atan(60/d)) ? d : FAR;
+}
+
+// Distances seen by the three sensors at ms: ahead, left, right
+static void Scene(int scene, int ms, double d[3]){
+  double t = ms/1000.0, w = 140 + 15*sin(2*M_PI*t/1.7);
+  int k;
+  d[0] = d[1] = d[2] = FAR;
+  if (scene == SC_HALLWAY){
+    d[1] = w/sin(SIDE);
+    d[2] = (350 - w)/sin(SIDE);
+  }else if (scene == SC_CORNERS){
+    int c = ms%3000;
+    if (c < 2500){                  // end wall closing in at 150 mm/s
+      double f = 150 + 0.15*(2500 - c);
+      d[0] = Walls(0, w, f);
+      d[1] = Walls(SIDE, w, f);
+      d[2] = Walls(-SIDE, w, f);
+    }else{                          // pivot right through 90 degrees
+      double th = -M_PI/2*(c - 2500)/500.0;
+      d[0] = Walls(th, 140, 150);
+      d[1] = Walls(th + SIDE, 140, 150);
+      d[2] = Walls(th - SIDE, 140, 150);
+    }
+  }else if (scene == SC_PERSON){
+    double p = 115 + 15*sin(2*M_PI*t/2.3), y = 40*sin(2*M_PI*t*0.8);
+    d[0] = Person(0, p, y);
+    d[1] = Person(SIDE, p, y);
+    d[2] = Person(-SIDE, p, y);
+  }else{
+    if (ms < 6000){
+      d[1] = w/sin(SIDE);
+    }
+    if (ms >= 4000){
+      double y = 40*sin(2*M_PI*t*0.8);
+      for(k=0; k<3; k++){
+        double q = Person((k == 0) ? 0 : (k == 1) ? SIDE : -SIDE, 250, y);
+        d[k] = (q < d[k]) ? q : d[k];
+      }
+    }
+  }
+}
+
+typedef struct {
+  int switches;                     // all runs
+  int first;                        // mode of the first switch
+  double best, mean, worst;         // ms from the scene change to the first switch
+  int switched;                     // runs with a switch
+} Result;
+
+static Result Run(int scene, uint8_t start, int change){
+  Result r = {0, MODESEL_NONE, SIM_MS, 0, 0, 0};
+  uint32_t seed;
+  for(seed=1; seed<=SEEDS; seed++){
+    SensorFrame ir = {0};
+    uint8_t mode = start;
+    double held[3] = {300, 300, 300};
+    int ms, k, first = -1;
+    Sim_Seed = seed;
+    ModeSelect_Init();
+    for(ms=0; ms<SIM_MS; ms+=2){
+      uint8_t next;
+      if ((ms%38) == 0){
+        double d[3];
+        Scene(scene, ms, d);
+        for(k=0; k<3; k++){
+          held[k] = Sim_IR(d[k]);
+        }
+      }
+      ir.ahead = held[0];
+      ir.left = held[1];
+      ir.right = held[2];
+      ir.stamp = ms*TICK_HZ/1000;
+      next = ModeSelect_Update(&ir, mode);
+      if (next != mode){
+        r.switches++;
+        if (first < 0){
+          first = ms;
+          if (r.first == MODESEL_NONE){
+            r.first = next;
+          }
+        }
+        mode = next;
+      }
+    }
+    if (first >= 0){
+      r.switched++;
+      r.mean += first - change;
+      if (first - change < r.best){
+        r.best = first - change;
+      }
+      if (first - change > r.worst){
+        r.worst = first - change;
+      }
+    }
+  }
+  if (r.switched){
+    r.mean /= r.switched;
+  }
+  printf("%-12s from %-10s %2d switches in %d s", SceneName[scene], ModeName[start],
+         r.switches, SEEDS*SIM_MS/1000);
+  if (r.switched){
+    printf(", first to %s after %.0f to %.0f ms, %.0f mean", ModeName[r.first],
+           r.best, r.worst, r.mean);
+  }
+  printf("\n");
+  return r;
+}
+
+int main(void){
+  // slowest switch: the window turns over, the evidence holds for the
+  // dwell, then it has to persist
+  const double slowest = MODESEL_WINDOW*MODESEL_SAMPLE_MS + MODESEL_DWELL_MS + MODESEL_PERSIST_MS;
+  Result r;
+  r = Run(SC_HALLWAY, MODESEL_WALL_LEFT, 0);
+  CHECK(r.switches == 0);
+  r = Run(SC_CORNERS, MODESEL_WALL_LEFT, 0);
+  CHECK(r.switches == 0);
+  r = Run(SC_PERSON, MODESEL_FOLLOW, 0);
+  CHECK(r.switches == 0);
+  r = Run(SC_WALLEND, MODESEL_WALL_LEFT, 6000);
+  CHECK(r.switches == SEEDS);       // once each, then stays
+  CHECK(r.first == MODESEL_FOLLOW);
+  CHECK(r.best >= MODESEL_PERSIST_MS);
+  CHECK(r.worst <= slowest);
+  return CHECK_DONE("modesel");
+}
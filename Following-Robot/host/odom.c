@@ -0,0 +1,94 @@
+// odom.c
+// Runs on a host PC
+// Checks Pose.c, the fixed-point dead reckoning behind Odometry.c.
+// The sine table is compared with the library sine over 2^20 angles.
+// Then 120 s of 1 kHz encoder counts from mixed driving (straights,
+// pivots and arcs up to 500 mm/s, a new manoeuvre every 2 s) go through
+// Pose_Step() and through a double-precision integrator that follows
+// each step's exact arc. Both see the same whole counts, so the
+// difference is the error of the fixed-point arithmetic alone.
+
+#include <stdint.h>
+#include "Check.h"
+#include "Sim.h"
+#include "Pose.h"
+
+#define STEPS    120000             // 1 ms each
+#define SEG_MS   2000
+#define MM_PER_COUNT  (M_PI*WHEEL_DIAMETER_UM/1000.0/ENCODER_CPR)
+#define BASE_MM       (WHEEL_BASE_UM/1000.0)
+
+int main(void){
+  // sine table
+  {
+    uint32_t i;
+    double worst = 0;
+    for(i=0; i<(1u<<20); i++){
+      uint32_t a = i<<12;
+      double e = fabs(Pose_Sin(a) - 32767*sin(a*(2*M_PI/4294967296.0)));
+      if (e > worst){
+        worst = e;
+      }
+    }
+    printf("sine table: worst error %.1f LSB in Q15\n", worst);
+    CHECK(worst < 8);               // 0.00024, the bound in Pose.h
+  }
+  // drift against exact arcs
+  {
+    Pose p = {0, 0, 0};
+    double x = 0, y = 0, th = 0, vl = 0, vr = 0, accl = 0, accr = 0;
+    double worst = 0, worst_th = 0, dist = 0;
+    int32_t i;
+    for(i=0; i<STEPS; i++){
+      int32_t dl, dr;
+      if ((i%SEG_MS) == 0){         // counts per ms, 3.3 is about 500 mm/s
+        int kind = Sim_Noise(1) + 1;
+        double v = 0.5 + (Sim_Noise(100) + 100)/71.0;
+        if (kind == 0){             // straight, either way
+          vl = vr = (Sim_Noise(1) >= 0) ? v : -v;
+        }else if (kind == 1){       // pivot
+          vl = (Sim_Noise(1) >= 0) ? v : -v;
+          vr = -vl;
+        }else{                      // arc
+          vl = v;
+          vr = v*(Sim_Noise(100) + 100)/200.0;
+        }
+      }
+      accl += vl;
+      accr += vr;
+      dl = (int32_t)accl;           // whole counts, as the QEI delivers them
+      dr = (int32_t)accr;
+      accl -= dl;
+      accr -= dr;
+      Pose_Step(&p, dl, dr);
+      {
+        double sl = dl*MM_PER_COUNT, sr = dr*MM_PER_COUNT;
+        double dth = (sr - sl)/BASE_MM, ds = (sl + sr)/2;
+        if (fabs(dth) < 1e-12){
+          x += ds*cos(th);
+          y += ds*sin(th);
+        }else{
+          x += ds/dth*(sin(th + dth) - sin(th));
+          y -= ds/dth*(cos(th + dth) - cos(th));
+        }
+        th += dth;
+        dist += fabs(ds);
+      }
+      {
+        double ex = p.x/65536.0 - x, ey = p.y/65536.0 - y;
+        double eth = remainder(p.theta*(2*M_PI/4294967296.0) - th, 2*M_PI);
+        if (hypot(ex, ey) > worst){
+          worst = hypot(ex, ey);
+        }
+        if (fabs(eth) > worst_th){
+          worst_th = fabs(eth);
+        }
+      }
+    }
+    printf("%.0f s, %.1f m driven: worst position error %.2f mm, heading %.3f deg\n",
+           STEPS/1000.0, dist/1000, worst, worst_th*180/M_PI);
+    CHECK(worst < 5);
+    CHECK(worst_th*180/M_PI < 0.5);
+  }
+  return CHECK_DONE("odom");
+}
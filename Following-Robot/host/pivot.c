@@ -0,0 +1,77 @@
+// pivot.c
+// Runs on a host PC
+// Turn-angle benchmark for Motion_Pivot(). Motion.c runs unchanged
+// against simulated wheels: the motor calls it makes set the duty,
+// direction and enable of each wheel, each wheel's speed lags its
+// command by SIM_TAU (30 ms when braked), and the encoder counts are
+// the wheel travel in whole counts. Motion_Tick() runs every 1 ms,
+// as from the SysTick ISR. The angle is read once the robot has come
+// to rest after the brake.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "Check.h"
+#include "Sim.h"
+#include "Motion.h"
+#include "Odometry.h"
+
+#define MM_PER_COUNT (M_PI*WHEEL_DIAMETER_UM/1000.0/ENCODER_CPR)
+#define BASE_MM      (WHEEL_BASE_UM/1000.0)
+
+unsigned long Host_Direction;       // DIRECTION, see Regs.h
+
+static uint16_t DutyL, DutyR;
+static uint8_t OnL, OnR;
+static double TravelL, TravelR;     // mm, forward positive
+
+void Set_L_Speed(uint16_t duty){ DutyL = duty; }
+void Set_R_Speed(uint16_t duty){ DutyR = duty; }
+void Start_Both_Wheels(void){ OnL = OnR = 1; }
+void Stop_Both_Wheels_Mode(uint8_t stop_mode){ OnL = OnR = 0; }
+int32_t Odometry_Left_Counts(void){ return (int32_t)floor(TravelL/MM_PER_COUNT); }
+int32_t Odometry_Right_Counts(void){ return (int32_t)floor(TravelR/MM_PER_COUNT); }
+
+// One 1 ms step of one wheel
+static void Wheel(double *v, double *travel, uint8_t on, uint16_t duty, int forward){
+  double target = on ? (forward ? 1 : -1)*SIM_VMAX*duty/PERIOD : 0;
+  *v += (target - *v)*0.001/(on ? SIM_TAU : 0.03);
+  *travel += *v*0.001;
+}
+
+// Signed angle in degrees turned by a pivot of deg at duty
+static double Pivot(int16_t deg, uint16_t duty, int *ms){
+  double vl = 0, vr = 0;
+  int t, rest = 0;
+  TravelL = TravelR = 0;
+  Motion_Pivot(deg, duty);
+  for(t=0; rest<300; t++){
+    Wheel(&vl, &TravelL, OnL, DutyL, (Host_Direction&0x04) != 0);
+    Wheel(&vr, &TravelR, OnR, DutyR, (Host_Direction&0x40) != 0);
+    Motion_Tick();
+    if (Motion_Status() == MOTION_BUSY){
+      *ms = t + 1;
+    }else{
+      rest++;                       // let it roll to a stop
+    }
+  }
+  return (TravelL - TravelR)/BASE_MM*180/M_PI;
+}
+
+int main(void){
+  static const int16_t angles[] = {30, 90, 180, -90};
+  static const uint16_t duties[] = {SPEED_35, SPEED_80};
+  unsigned i, j;
+  for(j=0; j<2; j++){
+    for(i=0; i<sizeof(angles)/sizeof(angles[0]); i++){
+      int ms = 0;
+      double turned = Pivot(angles[i], duties[j], &ms);
+      double err = fabs(turned) - abs(angles[i]);
+      printf("pivot %4d deg at %2d%% duty: turned %6.1f deg, error %+5.1f deg, %4d ms\n",
+             angles[i], duties[j]*100/PERIOD, turned, err, ms);
+      CHECK(Motion_Status() == MOTION_DONE);
+      CHECK((turned > 0) == (angles[i] > 0));
+      CHECK(fabs(err) < 2);
+    }
+  }
+  return CHECK_DONE("pivot");
+}
@@ -0,0 +1,87 @@
+// sched.c
+// Runs on a host PC
+// Checks Scheduler.c with a simulated time source: Now stands in for
+// SysTick_Cycles(), tick() for the SysTick ISR, and each task advances
+// Now by its execution time.
+
+#include <stdint.h>
+#include <string.h>
+#include "Check.h"
+#include "Scheduler.h"
+
+static uint32_t Now;
+static uint32_t Cycles(void){
+  return Now;
+}
+
+static char Order[16];
+static void Log(char c){
+  size_t n = strlen(Order);
+  if (n < sizeof(Order)-1){
+    Order[n] = c;
+  }
+}
+static void TaskA(void){ Log('A'); }
+static void TaskB(void){ Log('B'); }
+static void Busy(void){ Now += 250; }
+static void Light(void){ Now += 100; }
+
+int main(void){
+  uint32_t k;
+  // rates: 2 and 50 ticks, released on time and never skipped
+  {
+    static const Task table[] = {{TaskA, 2, 0}, {TaskB, 50, 1}};
+    Scheduler_Init(table, 2, Cycles);
+    for(k=0; k<1000; k++){
+      Scheduler_Tick();
+      Scheduler_Run();
+    }
+    CHECK(Scheduler_Stats(0)->runs == 500);
+    CHECK(Scheduler_Stats(1)->runs == 20);
+    CHECK(Scheduler_Stats(0)->skipped == 0);
+    CHECK(Scheduler_Stats(1)->skipped == 0);
+  }
+  // priority: released together, the earlier table entry runs first
+  {
+    static const Task table[] = {{TaskA, 4, 0}, {TaskB, 4, 0}};
+    memset(Order, 0, sizeof(Order));
+    Scheduler_Init(table, 2, Cycles);
+    CHECK(Scheduler_Ready() == 0);
+    Scheduler_Tick();
+    CHECK(Scheduler_Ready() == 1);
+    CHECK(Scheduler_Run() == 2);
+    CHECK(strcmp(Order, "AB") == 0);
+    CHECK(Scheduler_Ready() == 0);
+  }
+  // a main loop that falls behind runs the task once and counts the rest
+  {
+    static const Task table[] = {{TaskA, 2, 0}};
+    Scheduler_Init(table, 1, Cycles);
+    for(k=0; k<6; k++){             // releases at ticks 1, 3 and 5
+      Scheduler_Tick();
+    }
+    CHECK(Scheduler_Run() == 1);
+    CHECK(Scheduler_Stats(0)->skipped == 2);
+  }
+  // execution time, jitter and load from the time source
+  {
+    static const Task table[] = {{Busy, 1, 0}, {Light, 1, 0}};
+    Now = 0;
+    Scheduler_Init(table, 2, Cycles);
+    for(k=0; k<10; k++){
+      Now = k*1000;                 // 1000 time units per tick
+      Scheduler_Tick();
+      Scheduler_Run();
+    }
+    Now = 10000;
+    CHECK(Scheduler_Measure_Load() == 350);
+    CHECK(Scheduler_Stats(0)->load == 250);
+    CHECK(Scheduler_Stats(1)->load == 100);
+    CHECK(Scheduler_Stats(0)->wcet == 250);
+    CHECK(Scheduler_Stats(1)->wcet == 100);
+    CHECK(Scheduler_Stats(0)->max_jitter == 0);
+    CHECK(Scheduler_Stats(1)->max_jitter == 250); // waited for Busy
+    CHECK(Scheduler_Stats(0)->busy == 0);         // new window
+  }
+  return CHECK_DONE("sched");
+}
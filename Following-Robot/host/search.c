@@ -0,0 +1,150 @@
+// search.c
+// Runs on a host PC
+// Reacquire simulation for ST_SEARCH. Follow.c follows a target that
+// walks off sideways at a random speed and angle for 1.5 s, then
+// stops. Once nothing has been in view for SEARCH_LOST_MS the robot
+// searches with Search.c, as Behavior.c does, and the run ends when the target is back
+// in view. Each strategy gets the same 400 targets:
+//   none       keep running the follower, the behaviour before ST_SEARCH
+//   fixed      spin the same way every time
+//   sweep      turn towards the last-seen side for 0.6 s, then back
+//   last side  spin towards the side the target was last seen on, as
+//              Search_Propose() does
+// The IR cones are 12 degrees either side of each sensor's axis, the
+// side sensors 35 degrees off the heading; the cone model is an
+// assumption, not a measurement. Times include the loss detection.
+
+#include <stdint.h>
+#include "Check.h"
+#include "Sim.h"
+#include "Follow.h"
+#include "Search.h"
+#include "Motors.h"
+#include "ADC0SS2.h"
+
+#define RUNS 400
+#define CONE (12*M_PI/180)
+#define SIDE (35*M_PI/180)
+
+#define NONE      0
+#define FIXED     1
+#define SWEEP     2
+#define LAST_SIDE 3
+static const char *Name[] = {"none", "fixed", "sweep", "last side"};
+
+static double Rx, Ry, Rth, Tx, Ty;  // robot pose, target position, mm and rad
+
+// Reading of the sensor looking off rad from the heading
+static uint16_t Sense(double off){
+  double dx = Tx - Rx, dy = Ty - Ry, d = hypot(dx, dy);
+  double b = atan2(dy, dx) - Rth - off;
+  while(b > M_PI){
+    b -= 2*M_PI;
+  }
+  while(b < -M_PI){
+    b += 2*M_PI;
+  }
+  return Sim_IR(((fabs(b) < CONE)&&(d < 1000)) ? d : 1e9);
+}
+
+typedef struct {
+  int lost;                         // runs where the target got away
+  int found;                        // and was found again
+  double mean, worst;               // seconds from losing it to finding it
+} Result;
+
+static Result Run(int strategy){
+  Result r = {0, 0, 0, 0};
+  int run;
+  for(run=0; run<RUNS; run++){
+    double spd, dir, ang, vx, vy, vl = 0, vr = 0;
+    int16_t duty_l = 0, duty_r = 0;
+    int ms, start = -1, found = -1;
+    Sim_Seed = 7 + run;             // same target and noise for every strategy
+    Rx = Ry = Rth = 0;
+    Tx = 250 + Sim_Noise(100);
+    Ty = 0;
+    spd = 190 + Sim_Noise(110);     // mm/s
+    dir = (Sim_Noise(1) >= 0) ? 1 : -1;
+    ang = Sim_Noise(30)*M_PI/180;
+    vx = spd*cos(M_PI/2*dir + ang);
+    vy = spd*sin(M_PI/2*dir + ang);
+    Follow_Reset();
+    Search_Reset(0);                // 1 ms stamps, as SysTick
+    for(ms=0; (ms < 20000)&&(found < 0); ms++){
+      uint16_t ahead, left, right;
+      if (ms < 1500){
+        Tx += vx*0.001;
+        Ty += vy*0.001;
+      }
+      ahead = Sense(0);
+      right = Sense(SIDE);
+      left = Sense(-SIDE);
+      if ((ms%2) == 0){
+        if (Search_Track(ahead, left, right, ms)){
+          if (start >= 0){
+            found = ms;
+          }
+        }else if ((start < 0)&&Search_Lost(ms)){
+          start = ms;
+          Search_Start(ms);
+        }
+        if ((start < 0)||(strategy == NONE)){
+          Follow_Step(ahead, right, left, &duty_l, &duty_r);
+        }else if (Search_TimedOut(ms)){
+          duty_l = duty_r = 0;      // gave up
+        }else{
+          Search_Spin(&duty_l, &duty_r);
+          if (strategy == FIXED){
+            duty_l = -SEARCH_DUTY;
+            duty_r = SEARCH_DUTY;
+          }else if ((strategy == SWEEP)&&(ms - start >= 600)){
+            duty_l = -duty_l;       // and back
+            duty_r = -duty_r;
+          }
+        }
+      }
+      {
+        double v, w;
+        vl += (SIM_VMAX*duty_l/PERIOD - vl)*0.001/SIM_TAU;
+        vr += (SIM_VMAX*duty_r/PERIOD - vr)*0.001/SIM_TAU;
+        v = (vl + vr)/2;
+        w = (vr - vl)/SIM_TRACK;
+        Rx += v*cos(Rth)*0.001;
+        Ry += v*sin(Rth)*0.001;
+        Rth += w*0.001;
+      }
+    }
+    if (start < 0){
+      continue;                     // kept it in view
+    }
+    r.lost++;
+    if (found >= 0){
+      double t = (found - start + SEARCH_LOST_MS)/1000.0;
+      r.found++;
+      r.mean += t;
+      if (t > r.worst){
+        r.worst = t;
+      }
+    }
+  }
+  if (r.found){
+    r.mean /= r.found;
+  }
+  printf("%-9s lost %d, reacquired %d (%.0f%%), mean %.2f s, worst %.2f s\n",
+         Name[strategy], r.lost, r.found, 100.0*r.found/r.lost, r.mean, r.worst);
+  return r;
+}
+
+int main(void){
+  Result none, fixed, last;
+  none = Run(NONE);
+  fixed = Run(FIXED);
+  Run(SWEEP);
+  last = Run(LAST_SIDE);
+  CHECK(none.found < none.lost/2);
+  CHECK(last.found >= last.lost*99/100);
+  CHECK(last.mean < fixed.mean);
+  CHECK(last.worst < 2.0);
+  return CHECK_DONE("search");
+}
@@ -0,0 +1,228 @@
+// stall.c
+// Runs on a host PC
+// Checks WheelWatch.c, the window arithmetic of Stall.c, on one
+// simulated wheel, next to the check it replaced, which read the enable
+// at both ends of the window and the duty at its end only.
+// Wheel model: a free wheel makes STALL_MAX_CPS at 100% duty, with an 8%
+// deadband; its speed lags the command by SIM_TAU when driven and by
+// 40 ms when coasting (a 120:1 gearbox). A jammed wheel stops dead.
+// Counts are whole.
+//   jam      driving steadily, the wheel jams at a random time; the time
+//            from the jam to the trip is the detection latency
+//   chatter  the enable toggles every 5 to 40 ms and the duty jumps
+//            between SPEED_35 and SPEED_98, as a bang-bang steering
+//            loop drives it, for 10 minutes
+//   pulses   20 ms on every 99 ms, for 10 minutes
+//   spin-up  starts from rest, linear ramps and full reversals at
+//            random duties, for 10 minutes
+// A trip in the last three is a false trip.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "Check.h"
+#include "Sim.h"
+#include "WheelWatch.h"
+#include "Stall.h"
+#include "Motors.h"
+
+#define WINDOW   STALL_WINDOW_MS    // ticks, 1 ms each
+#define DEAD     (PERIOD*8/100)
+#define SIM_MS   600000
+#define JAMS     200
+
+// The check Stall.c used before, kept here as the baseline
+typedef struct {
+  int32_t start;
+  uint8_t on;
+  uint8_t bad;
+} OldWatch;
+
+static uint8_t Old_End(OldWatch *w, int32_t counts, uint8_t on, uint32_t duty){
+  int32_t travel = counts - w->start;
+  uint32_t expected;
+  if (travel < 0){
+    travel = -travel;
+  }
+  if (w->on && on && (duty >= STALL_MIN_DUTY)){
+    expected = (duty*STALL_MAX_CPS/PERIOD)*STALL_WINDOW_MS/1000;
+    if ((uint32_t)travel*100 < expected*STALL_FRACTION_PCT){
+      w->bad++;
+    }else{
+      w->bad = 0;
+    }
+  }else{
+    w->bad = 0;
+  }
+  w->start = counts;
+  w->on = on;
+  return w->bad >= STALL_WINDOWS;
+}
+
+// Wheel state and command
+static double V, Pos;               // counts/s, counts
+static uint8_t On, Jammed;
+static uint32_t Duty;               // PWM counts
+static int Dir;                     // +1 or -1
+
+static void Wheel_Step(void){
+  if (Jammed){
+    V = 0;
+    return;
+  }
+  if (On){
+    double target = (Duty > DEAD) ? Dir*(double)STALL_MAX_CPS*(Duty - DEAD)/(PERIOD - DEAD) : 0;
+    V += (target - V)*0.001/SIM_TAU;
+  }else{
+    V -= V*0.001/0.040;
+  }
+  Pos += V*0.001;
+}
+
+typedef struct {
+  int trips, old_trips;             // windows that tripped
+  int first, old_first;             // ms of the first trip, -1 if none
+} Result;
+
+// Runs the wheel for ms, calling command(t) every tick to set the
+// command, with both checks watching
+static Result Run(int ms, void (*command)(int t)){
+  Result r = {0, 0, -1, -1};
+  WheelWatch w;
+  OldWatch o = {0, 0, 0};
+  int t;
+  V = Pos = 0;
+  On = Jammed = 0;
+  Duty = 0;
+  Dir = 1;
+  WheelWatch_Reset(&w, 0);
+  for(t=0; t<ms; t++){
+    int32_t counts;
+    command(t);
+    Wheel_Step();
+    counts = (int32_t)floor(Pos);
+    WheelWatch_Sample(&w, counts, On, Duty);
+    if (((t + 1)%WINDOW) == 0){
+      if (WheelWatch_End(&w)){
+        r.trips++;
+        if (r.first < 0){
+          r.first = t;
+        }
+        WheelWatch_Reset(&w, counts); // as Stall_Clear()
+      }
+      if (Old_End(&o, counts, On, Duty)){
+        r.old_trips++;
+        if (r.old_first < 0){
+          r.old_first = t;
+        }
+        o.bad = 0;
+        o.on = 0;
+      }
+    }
+  }
+  return r;
+}
+
+// jam
+static int JamAt;
+static uint32_t JamDuty;
+static void Jam(int t){
+  On = 1;
+  Duty = JamDuty;
+  Jammed = (t >= JamAt);
+}
+
+// chatter
+static int Next;
+static void Chatter(int t){
+  if (t >= Next){
+    On = (Sim_Noise(1) >= 0);
+    Duty = (Sim_Noise(1) >= 0) ? SPEED_98 : SPEED_35;
+    Next = t + 22 + Sim_Noise(17);
+  }
+}
+
+// pulses
+static void Pulses(int t){
+  On = ((t%99) < 20);
+  Duty = SPEED_80;
+}
+
+// spin-up
+static int RampStart, RampMs;
+static uint32_t RampTo;
+static void SpinUp(int t){
+  if (t >= Next){
+    int kind = Sim_Noise(1) + 1;
+    RampTo = STALL_MIN_DUTY + abs(Sim_Noise((SPEED_98 - STALL_MIN_DUTY)/2))*2;
+    RampStart = t;
+    RampMs = 0;
+    if ((kind == 0)||!On){          // start from rest after a pause
+      On = 0;
+      RampStart = t + 100 + abs(Sim_Noise(400));
+    }else if (kind == 1){           // ramp from the deadband, as Trajectory.c does
+      RampMs = 100 + abs(Sim_Noise(200));
+    }else{                          // reverse at full duty
+      Dir = -Dir;
+    }
+    Next = RampStart + RampMs + 300 + abs(Sim_Noise(1700));
+  }
+  if (t >= RampStart){
+    On = 1;
+    Duty = (t - RampStart < RampMs) ? STALL_MIN_DUTY + (RampTo - STALL_MIN_DUTY)*(t - RampStart)/RampMs : RampTo;
+  }
+}
+
+int main(void){
+  // detection latency
+  {
+    static const uint32_t duties[] = {STALL_MIN_DUTY, SPEED_35, SPEED_60, SPEED_98};
+    unsigned i;
+    int k;
+    for(i=0; i<4; i++){
+      int worst = 0, missed = 0, old_worst = 0, old_missed = 0;
+      double mean = 0, old_mean = 0;
+      Sim_Seed = 1;
+      JamDuty = duties[i];
+      for(k=0; k<JAMS; k++){
+        Result r;
+        JamAt = 1000 + abs(Sim_Noise(500));
+        r = Run(JamAt + 2000, Jam);
+        if (r.first < 0){
+          missed++;
+        }else{
+          mean += r.first - JamAt;
+          worst = (r.first - JamAt > worst) ? r.first - JamAt : worst;
+        }
+        if (r.old_first < 0){
+          old_missed++;
+        }else{
+          old_mean += r.old_first - JamAt;
+          old_worst = (r.old_first - JamAt > old_worst) ? r.old_first - JamAt : old_worst;
+        }
+      }
+      printf("jam at %2d%% duty: mean %3.0f ms, worst %3d ms, missed %d (was %3.0f, %3d, %d)\n",
+             duties[i]*100/PERIOD, mean/(JAMS - missed), worst, missed,
+             old_mean/(JAMS - old_missed), old_worst, old_missed);
+      CHECK(missed == 0);
+      CHECK(worst <= (STALL_WINDOWS + 1)*STALL_WINDOW_MS);
+    }
+  }
+  // false trips
+  {
+    Result r;
+    Sim_Seed = 2;
+    Next = 0;
+    r = Run(SIM_MS, Chatter);
+    printf("chatter: %d false trips in %d min (was %d)\n", r.trips, SIM_MS/60000, r.old_trips);
+    CHECK(r.trips == 0);
+    r = Run(SIM_MS, Pulses);
+    printf("pulses:  %d false trips in %d min (was %d)\n", r.trips, SIM_MS/60000, r.old_trips);
+    CHECK(r.trips == 0);
+    Sim_Seed = 3;
+    Next = 0;
+    r = Run(SIM_MS, SpinUp);
+    printf("spin-up: %d false trips in %d min (was %d)\n", r.trips, SIM_MS/60000, r.old_trips);
+    CHECK(r.trips == 0);
+  }
+  return CHECK_DONE("stall");
+}
@@ -0,0 +1,62 @@
+// steerlut.c
+// Runs on a host PC
+// Checks the generated SteerLut[] against Steer_Decide(), the branches
+// it was generated from, with the real STEER_CELL() from SteerLut.h.
+// A decision depends on each reading only through comparisons with the
+// thresholds, so the grid is: every 12-bit reading on one axis with
+// the other two at every edge value (0, 4095 and each threshold and
+// its neighbours), for each axis and policy; then every 16th reading
+// on all three axes at once.
+
+#include <stdint.h>
+#include "Check.h"
+#include "SteerLut.h"
+#include "Steer.h"
+#include "ADC0SS2.h"
+
+static const uint16_t Edge[] = {
+  0, WALL_DIST-1, WALL_DIST, WALL_DIST+1, FOLLOW_DIST-1, FOLLOW_DIST, FOLLOW_DIST+1,
+  FOLLOW_DIST+199, FOLLOW_DIST+200, FOLLOW_DIST+201, STOP_DIST-1, STOP_DIST, STOP_DIST+1, 4095
+};
+#define EDGES (sizeof(Edge)/sizeof(Edge[0]))
+
+static uint32_t Checked, Wrong;
+
+static void Compare(uint8_t p, uint16_t ahead, uint16_t left, uint16_t right){
+  uint8_t lut = SteerLut[p][STEER_CELL(ahead, left, right)];
+  uint8_t ref = Steer_Decide(p, ahead, left, right);
+  Checked++;
+  if (lut != ref){
+    if (Wrong < 5){
+      printf("policy %d ahead %d left %d right %d: table 0x%02X, branches 0x%02X\n",
+             p, ahead, left, right, lut, ref);
+    }
+    Wrong++;
+  }
+}
+
+int main(void){
+  uint8_t p;
+  uint32_t v, i, j, a, l, r;
+  for(p=0; p<STEER_POLICIES; p++){
+    for(v=0; v<4096; v++){
+      for(i=0; i<EDGES; i++){
+        for(j=0; j<EDGES; j++){
+          Compare(p, v, Edge[i], Edge[j]);
+          Compare(p, Edge[i], v, Edge[j]);
+          Compare(p, Edge[i], Edge[j], v);
+        }
+      }
+    }
+    for(a=0; a<4096; a+=16){
+      for(l=0; l<4096; l+=16){
+        for(r=0; r<4096; r+=16){
+          Compare(p, a, l, r);
+        }
+      }
+    }
+  }
+  printf("%u readings checked, %u differ\n", (unsigned)Checked, (unsigned)Wrong);
+  CHECK(Wrong == 0);
+  return CHECK_DONE("steerlut");
+}
@@ -0,0 +1,205 @@
+// track.c
+// Runs on a host PC
+// Checks Tracker.c on synthetic ramps, then runs Follow.c behind a
+// walking target and reports how well it keeps range and bearing.
+// The closed-loop model adds what the front reading goes through on
+// the robot: the Sharp output only refreshes every 38 ms, the ADC adds
+// +/-30 counts of noise to every sample and ReadADCMedianFilter() takes
+// the median of the last three. The target starts at the set point,
+// walks straight away at 100 to 250 mm/s from 0.5 s, and in half the
+// runs turns at 20 deg/s from 2.5 s to 5.5 s.
+// The Makefile builds Follow.c twice, with FOLLOW_PREDICT=1 as
+// Follow_Step() and with FOLLOW_PREDICT=0 as Reactive_Step(), so both
+// run on the same targets and noise.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "Check.h"
+#include "Sim.h"
+#include "Tracker.h"
+#include "Follow.h"
+#include "Motors.h"
+#include "ADC0SS2.h"
+
+#define CONE   (12*M_PI/180)
+#define SIDE   (35*M_PI/180)
+#define SIM_MS 8000
+
+// Follow.c built with FOLLOW_PREDICT=0
+void Reactive_Reset(void);
+void Reactive_Step(uint16_t ahead, uint16_t right, uint16_t left, int16_t *duty_l, int16_t *duty_r);
+
+typedef struct {
+  const char *name;
+  void (*reset)(void);
+  void (*step)(uint16_t ahead, uint16_t right, uint16_t left, int16_t *duty_l, int16_t *duty_r);
+} Follower;
+static const Follower Predict = {"predicted", Follow_Reset, Follow_Step};
+static const Follower Reactive = {"reactive", Reactive_Reset, Reactive_Step};
+
+static double Rx, Ry, Rth, Tx, Ty;  // robot pose, target position, mm and rad
+
+static double Wrap(double a){
+  while(a > M_PI){
+    a -= 2*M_PI;
+  }
+  while(a < -M_PI){
+    a += 2*M_PI;
+  }
+  return a;
+}
+
+// Sharp output of the sensor looking off rad from the heading, before
+// the ADC. The target is 100 mm wide.
+static double Sharp(double off){
+  double dx = Tx - Rx, dy = Ty - Ry, d = hypot(dx, dy);
+  double b = Wrap(atan2(dy, dx) - Rth - off);
+  if ((fabs(b) < CONE + atan(50.0/d))&&(d < 1000)){
+    return (285000.0/d > 4095) ? 4095 : 285000.0/d;
+  }
+  return 300;
+}
+
+static int32_t Median(int32_t a, int32_t b, int32_t c){
+  int32_t t;
+  if (a > b){ t = a; a = b; b = t; }
+  if (b > c){ b = c; }
+  return (a > b) ? a : b;
+}
+
+typedef struct {
+  double range;                     // rms distance error, mm
+  double bearing;                   // rms bearing error, degrees
+  double chatter;                   // sum of |duty change| of both wheels per second
+} Result;
+
+static Result Run(const Follower *f, double speed, double turn, uint32_t seed){
+  Result r = {0, 0, 0};
+  double sp = 285000.0/FOLLOW_DIST, heading = 0, vl = 0, vr = 0;
+  double held[3] = {0, 0, 0}, se = 0, sb = 0;
+  int32_t hist[3][3] = {{0}};
+  int16_t duty_l = 0, duty_r = 0, last_l = 0, last_r = 0;
+  int ms, k, n = 0, phase;
+  Sim_Seed = seed;
+  phase = Sim_Noise(18) + 18;       // where in its 38 ms cycle the sensor starts
+  Rx = Ry = Rth = 0;
+  Tx = sp; Ty = 0;
+  f->reset();
+  for(ms=0; ms<SIM_MS; ms++){
+    int32_t z[3];
+    if (ms >= 500){
+      if ((ms >= 2500)&&(ms < 5500)){
+        heading += turn*M_PI/180*0.001;
+      }
+      Tx += speed*cos(heading)*0.001;
+      Ty += speed*sin(heading)*0.001;
+    }
+    if (((ms + phase)%38) == 0){
+      held[0] = Sharp(0);
+      held[1] = Sharp(SIDE);
+      held[2] = Sharp(-SIDE);
+    }
+    for(k=0; k<3; k++){
+      int32_t raw = (int32_t)held[k] + Sim_Noise(30);
+      raw = (raw < 0) ? 0 : (raw > 4095) ? 4095 : raw;
+      hist[k][2] = hist[k][1];
+      hist[k][1] = hist[k][0];
+      hist[k][0] = raw;
+      z[k] = Median(hist[k][0], hist[k][1], hist[k][2]);
+    }
+    if ((ms%2) == 0){
+      f->step(z[0], z[1], z[2], &duty_l, &duty_r);
+      r.chatter += abs(duty_l - last_l) + abs(duty_r - last_r);
+      last_l = duty_l;
+      last_r = duty_r;
+    }
+    {
+      double v, w;
+      vl += (SIM_VMAX*duty_l/PERIOD - vl)*0.001/SIM_TAU;
+      vr += (SIM_VMAX*duty_r/PERIOD - vr)*0.001/SIM_TAU;
+      v = (vl + vr)/2;
+      w = (vr - vl)/SIM_TRACK;
+      Rx += v*cos(Rth)*0.001;
+      Ry += v*sin(Rth)*0.001;
+      Rth += w*0.001;
+    }
+    if (ms >= 1000){
+      double dx = Tx - Rx, dy = Ty - Ry, b = Wrap(atan2(dy, dx) - Rth);
+      se += (hypot(dx, dy) - sp)*(hypot(dx, dy) - sp);
+      sb += b*b;
+      n++;
+    }
+  }
+  r.range = sqrt(se/n);
+  r.bearing = sqrt(sb/n)*180/M_PI;
+  r.chatter /= SIM_MS/1000.0;
+  return r;
+}
+
+// Mean of 12 runs: four walking speeds, three seeds each
+static Result Average(const Follower *f, double turn){
+  static const double speeds[] = {100, 150, 200, 250};
+  Result sum = {0, 0, 0};
+  unsigned i;
+  uint32_t seed;
+  for(i=0; i<4; i++){
+    for(seed=1; seed<=3; seed++){
+      Result r = Run(f, speeds[i], turn, seed);
+      sum.range += r.range/12;
+      sum.bearing += r.bearing/12;
+      sum.chatter += r.chatter/12;
+    }
+  }
+  printf("%-9s turn %2.0f deg/s: range %.1f mm rms, bearing %.2f deg rms, duty changes %.0f/s\n",
+         f->name, turn, sum.range, sum.bearing, sum.chatter);
+  return sum;
+}
+
+int main(void){
+  // a ramp is followed without lag, and predicted ahead
+  {
+    static const TrackerGains g = {1000, 100};
+    Tracker t = {&g};
+    int32_t i;
+    for(i=0; i<200; i++){
+      Tracker_Update(&t, 1000 + 3*i);
+    }
+    CHECK(abs(Tracker_Predict(&t, 0) - (1000 + 3*199)) <= 1);
+    CHECK(abs(Tracker_Predict(&t, 10) - (1000 + 3*209)) <= 1);
+    Tracker_Reset(&t);
+    Tracker_Update(&t, 500);        // restarts at rest on the measurement
+    CHECK(Tracker_Predict(&t, 10) == 500);
+  }
+  // noise on a constant is smoothed
+  {
+    static const TrackerGains g = {200, 2};   // Follow.c's range gains
+    Tracker t = {&g};
+    double raw = 0, est = 0;
+    int32_t i;
+    Sim_Seed = 1;
+    for(i=0; i<2000; i++){
+      int32_t z = 2500 + Sim_Noise(30);
+      Tracker_Update(&t, z);
+      if (i >= 500){
+        raw += (z - 2500)*(z - 2500);
+        est += (double)(Tracker_Predict(&t, 0) - 2500)*(Tracker_Predict(&t, 0) - 2500);
+      }
+    }
+    printf("noise on a constant: %.1f counts rms raw, %.1f tracked\n", sqrt(raw/1500), sqrt(est/1500));
+    CHECK(est < raw/4);
+  }
+  // closed loop, both variants
+  {
+    double turn;
+    for(turn=0; turn<=20; turn+=20){
+      Result p = Average(&Predict, turn), r = Average(&Reactive, turn);
+      CHECK(p.range < r.range);
+      CHECK(p.chatter < r.chatter/2); // ADC noise kept out of the range derivative
+      CHECK(p.range < 40);
+      CHECK(r.range < 40);
+      CHECK(p.bearing < 5);
+      CHECK(r.bearing < 5);
+    }
+  }
+  return CHECK_DONE("track");
+}
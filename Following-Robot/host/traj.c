@@ -0,0 +1,163 @@
+// traj.c
+// Runs on a host PC
+// Timing benchmark for Trajectory.c. A main loop with random iteration
+// times plays the same plan of ramped segments two ways:
+//   direct  the loop works out the command for the current time and
+//           writes it itself, as Behavior.c did before the queue
+//   queue   the loop keeps the queue topped up with Trajectory_Push()
+//           and Trajectory_Tick() plays it back every 1 ms
+// For each segment the time the motors reach its end-of-ramp command is
+// compared with the time the plan says, and the lateness is histogrammed.
+// The loop times are an assumption, not a measurement: 2 to 12 ms per
+// iteration, and one iteration in 19 stalls for 40 to 120 ms (an LCD
+// redraw or a UART dump).
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "Check.h"
+#include "Sim.h"
+#include "Trajectory.h"
+#include "Motors.h"
+
+#define SEGS 300
+#define BINS 8
+static const char *BinName[BINS] = {"0", "1", "2-4", "5-9", "10-19", "20-49", "50+", "missed"};
+
+static Segment Plan[SEGS];
+static uint32_t Start[SEGS + 1];    // ms, Start[SEGS] is the end of the plan
+static int32_t Hit[SEGS];           // ms the end-of-ramp command was written, -1 if never
+static uint32_t Now;
+static int Reached;                 // next segment whose command the queue run waits for
+
+void Set_Wheels(int16_t left, int16_t right){
+  if ((Reached < SEGS)&&(left == Plan[Reached].left)&&(right == Plan[Reached].right)){
+    Hit[Reached++] = Now;
+  }
+}
+void Stop_Both_Wheels_Mode(uint8_t stop_mode){}
+
+static void Make_Plan(uint16_t duration_ms, uint16_t ramp_ms){
+  int k;
+  for(k=0; k<SEGS; k++){
+    do{                             // never the same command twice in a row
+      Plan[k].left = (Sim_Noise(1) >= 0 ? 1 : -1)*(SPEED_35 + abs(Sim_Noise(SPEED_80 - SPEED_35)));
+      Plan[k].right = (Sim_Noise(1) >= 0 ? 1 : -1)*(SPEED_35 + abs(Sim_Noise(SPEED_80 - SPEED_35)));
+    }while((k > 0)&&(Plan[k].left == Plan[k-1].left)&&(Plan[k].right == Plan[k-1].right));
+    Plan[k].duration_ms = duration_ms;
+    Plan[k].ramp_ms = ramp_ms;
+    Start[k+1] = Start[k] + duration_ms;
+  }
+}
+
+static uint32_t Loop_Time(void){
+  if (Sim_Noise(9) == 0){
+    return 80 + Sim_Noise(40);
+  }
+  return 7 + Sim_Noise(5);
+}
+
+// When the end-of-ramp command of segment k is due, in the timing of
+// Trajectory_Tick(): the first tick of a segment is Elapsed 1
+static uint32_t Due(int k){
+  return Start[k] + (Plan[k].ramp_ms ? Plan[k].ramp_ms : 1) - 1;
+}
+
+static void Direct(void){
+  uint32_t next = 0;
+  int k;
+  for(k=0; k<SEGS; k++){
+    Hit[k] = -1;
+  }
+  for(Now=0; Now<Start[SEGS]; Now++){
+    if (Now >= next){
+      for(k=0; Start[k+1] <= Now; k++){};
+      if ((Hit[k] < 0)&&(Now >= Due(k))){
+        Hit[k] = Now;
+      }
+      next = Now + Loop_Time();
+    }
+  }
+}
+
+static void Queue(void){
+  uint32_t next = 0;
+  int pushed = 0;
+  Reached = 0;
+  Trajectory_Init();
+  for(Now=0; (Now<Start[SEGS] + 1000)&&(Reached < SEGS); Now++){
+    if (Now >= next){
+      while((pushed < SEGS)&&Trajectory_Push(Plan[pushed].left, Plan[pushed].right,
+                                              Plan[pushed].duration_ms, Plan[pushed].ramp_ms)){
+        pushed++;
+      }
+      next = Now + Loop_Time();
+    }
+    Trajectory_Tick();
+  }
+  for(; Reached<SEGS; Reached++){
+    Hit[Reached] = -1;
+  }
+}
+
+static int Bin(int32_t late){
+  if (late < 0) return 7;
+  if (late == 0) return 0;
+  if (late == 1) return 1;
+  if (late < 5) return 2;
+  if (late < 10) return 3;
+  if (late < 20) return 4;
+  if (late < 50) return 5;
+  return 6;
+}
+
+// Lateness histogram of the last run; returns the worst lateness, or
+// -1 if a segment never reached its command
+static int32_t Report(const char *name){
+  int hist[BINS] = {0}, k, b;
+  int32_t worst = 0;
+  for(k=0; k<SEGS; k++){
+    int32_t late = (Hit[k] < 0) ? -1 : Hit[k] - (int32_t)Due(k);
+    hist[Bin(late)]++;
+    if ((late < 0)||(worst < 0)){
+      worst = -1;
+    }else if (late > worst){
+      worst = late;
+    }
+  }
+  printf("  %-6s", name);
+  for(b=0; b<BINS; b++){
+    printf(" %6d", hist[b]);
+  }
+  if (worst < 0){
+    printf("   worst: segments missed\n");
+  }else{
+    printf("   worst %d ms\n", worst);
+  }
+  return worst;
+}
+
+static void Compare(uint16_t duration_ms, uint16_t ramp_ms){
+  int32_t direct, queue;
+  int b;
+  Sim_Seed = 1;
+  Make_Plan(duration_ms, ramp_ms);
+  printf("%d segments of %d ms, %d ms ramp; lateness in ms:\n        ", SEGS, duration_ms, ramp_ms);
+  for(b=0; b<BINS; b++){
+    printf(" %6s", BinName[b]);
+  }
+  printf("\n");
+  Sim_Seed = 2;                     // same loop times for both
+  Direct();
+  direct = Report("direct");
+  Sim_Seed = 2;
+  Queue();
+  queue = Report("queue");
+  CHECK(queue == 0);                // every segment on its tick
+  CHECK((direct < 0)||(direct > 20));
+}
+
+int main(void){
+  Compare(300, 60);
+  Compare(40, 10);
+  return CHECK_DONE("traj");
+}
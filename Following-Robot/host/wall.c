@@ -0,0 +1,149 @@
+// wall.c
+// Runs on a host PC
+// Lap simulation of Wall.c in a closed 2000 x 1500 mm room.
+// The robot starts on the bottom wall heading left with the wall on its
+// left, as in mode 2. Front and side readings come from ray casts
+// through Sim_IR(); the side sensor looks SideDeg off the heading.
+// A differential-drive model moves the robot every 1 ms, the
+// controller runs every 2 ms. Corners are turned as object_steering
+// does: a 90 degree pivot at SPEED_80 when a wall is ahead and the side
+// wall is still there.
+// Reported per run: lap time, lateral error on the straights (where
+// the wall ahead is more than 400 mm off) and average speed. The
+// original bang-bang logic is run too, for comparison. The PD follower
+// must finish the lap without touching a wall and hold the wall within
+// the checked error.
+
+#include <stdint.h>
+#include <math.h>
+#include "Check.h"
+#include "Sim.h"
+#include "Wall.h"
+#include "Motors.h"
+#include "ADC0SS2.h"
+
+#define ROOM_W  2000.0
+#define ROOM_H  1500.0
+#define SIM_MS  60000
+
+static double X, Y, Th;             // mm, mm, rad
+
+// Distance from the robot to the room wall along heading a
+static double Ray(double a){
+  double c = cos(a), s = sin(a), best = 1e9, t;
+  if (c > 1e-9){ t = (ROOM_W - X)/c; if (t < best) best = t; }
+  if (c < -1e-9){ t = -X/c; if (t < best) best = t; }
+  if (s > 1e-9){ t = (ROOM_H - Y)/s; if (t < best) best = t; }
+  if (s < -1e-9){ t = -Y/s; if (t < best) best = t; }
+  return best;
+}
+
+typedef struct {
+  int lap_ms;                       // 0: crashed or no lap
+  double rms, max;                  // lateral error, mm
+  double speed;                     // mm/s
+} Result;
+
+static Result Run(int pd, double side_deg){
+  Result r = {0, 0, 0, 0};
+  double side_ang = side_deg*M_PI/180;
+  double sp = 285000.0/WALL_DIST*sin(side_ang); // side reading at WALL_DIST, as a perpendicular distance
+  double vl = 0, vr = 0, turned = 0, dist = 0, se = 0, pivot_from = 0;
+  double duty_in = 0, duty_out = 0;
+  int ms, n = 0, pivot = 0;
+  X = 1500; Y = sp; Th = M_PI;
+  Wall_Reset();
+  for(ms=0; ms<SIM_MS; ms++){
+    uint16_t ahead = Sim_IR(Ray(Th)), side = Sim_IR(Ray(Th + side_ang));
+    if ((ms%2) == 0){
+      if (pivot && (fabs(Th - pivot_from) >= M_PI/2)){
+        pivot = 0;
+        duty_in = duty_out = 0;
+        Wall_Reset();
+      }
+      if (!pivot){
+        if (pd){
+          if ((ahead > WALL_DIST)&&(side >= WALL_DIST)){
+            pivot = 1;
+          }else{
+            int16_t in, out;
+            Wall_Step(ahead, side, &in, &out);
+            duty_in = in;
+            duty_out = out;
+          }
+        }else if (side < WALL_DIST){  // Move_Left_Forward
+          duty_in = SPEED_80;
+          duty_out = SPEED_35;
+        }else if (ahead > WALL_DIST){
+          pivot = 1;
+        }else{                        // Move_Forward
+          duty_in = duty_out = SPEED_98;
+        }
+        if (pivot){
+          pivot_from = Th;
+          duty_in = -SPEED_80;
+          duty_out = SPEED_80;
+        }
+      }
+    }
+    {                                 // in: right wheel, turns towards the left wall
+      double v, w;
+      vr += (SIM_VMAX*duty_in/PERIOD - vr)*0.001/SIM_TAU;
+      vl += (SIM_VMAX*duty_out/PERIOD - vl)*0.001/SIM_TAU;
+      v = (vl + vr)/2;
+      w = (vr - vl)/SIM_TRACK;
+      X += v*cos(Th)*0.001;
+      Y += v*sin(Th)*0.001;
+      Th += w*0.001;
+      turned += w*0.001;
+      dist += fabs(v)*0.001;
+    }
+    if ((X < 0)||(Y < 0)||(X > ROOM_W)||(Y > ROOM_H)){
+      return r;                       // hit a wall
+    }
+    if (Ray(Th) > 400){
+      double dl = Ray(Th + M_PI/2);
+      if (dl < 500){
+        double e = dl - sp;
+        se += e*e;
+        n++;
+        if (fabs(e) > r.max){
+          r.max = fabs(e);
+        }
+      }
+    }
+    if ((turned <= -2*M_PI)&&(X <= 1500)&&(Y < ROOM_H/2)){
+      r.lap_ms = ms;
+      break;
+    }
+  }
+  r.rms = sqrt(se/(n ? n : 1));
+  r.speed = dist/(ms/1000.0);
+  return r;
+}
+
+static Result Report(int pd, double side_deg){
+  Result r = Run(pd, side_deg);
+  if (r.lap_ms){
+    printf("%-5s side sensor %2.0f deg: lap %.2f s, lateral rms %.0f mm max %.0f mm, avg speed %.0f mm/s\n",
+           pd ? "PD" : "bang", side_deg, r.lap_ms/1000.0, r.rms, r.max, r.speed);
+  }else{
+    printf("%-5s side sensor %2.0f deg: no lap\n", pd ? "PD" : "bang", side_deg);
+  }
+  return r;
+}
+
+int main(void){
+  Result r;
+  Report(0, 45);
+  r = Report(1, 45);
+  CHECK(r.lap_ms != 0);
+  CHECK(r.lap_ms < 20000);
+  CHECK(r.rms < 40);
+  CHECK(r.max < 100);
+  Report(0, 60);
+  r = Report(1, 60);
+  CHECK(r.lap_ms != 0);
+  CHECK(r.rms < 60);
+  return CHECK_DONE("wall");
+}
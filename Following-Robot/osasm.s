@@ -0,0 +1,77 @@
+;******************************************************************************
+;
+; osasm.s
+; Runs on TM4C123
+; Context switch and first thread launch for the kernel in OS.c.
+; PendSV_Handler replaces the weak default in startup.s.
+;
+;******************************************************************************
+
+        AREA |.text|, CODE, READONLY, ALIGN=2
+        THUMB
+        REQUIRE8
+        PRESERVE8
+
+        EXTERN  RunPt               ; currently running thread
+        EXTERN  NextPt              ; thread to switch to
+        EXTERN  OS_SwitchCycles     ; worst switch time, cycles
+        EXPORT  OS_Launch
+        EXPORT  PendSV_Handler
+
+DWT_CYCCNT EQU  0xE0001004
+
+;*********** OS_Launch ***************
+; Start the first thread on PSP. Its stack was built by OS_AddThread
+; with R4-R11 below an exception frame; neither needs to be restored.
+; inputs:  R0 = TCB of the first thread
+; outputs: none, does not return
+OS_Launch
+        LDR     R1, =RunPt
+        STR     R0, [R1]
+        LDR     R2, [R0]            ; R2 = thread sp
+        ADDS    R2, R2, #64         ; drop R4-R11 and R0-R3,R12,LR,PC,xPSR
+        MSR     PSP, R2
+        MOVS    R1, #2
+        MSR     CONTROL, R1         ; thread mode now uses PSP
+        ISB
+        LDR     R1, [R2, #-8]       ; PC from the initial frame
+        CPSIE   I
+        BX      R1
+
+;*********** PendSV_Handler ***************
+; Save R4-R11 of RunPt on its stack, switch to NextPt, restore its
+; R4-R11. The hardware stacks and restores the rest on exception
+; entry and exit. The cycles spent here are measured with the DWT
+; counter and the worst case kept in OS_SwitchCycles.
+; Cycles from the listing, Cortex-M4 TRM timings with the flash at
+; zero wait states (16 MHz), at the start of each comment: 54 from entry
+; to BX LR, 37 of them between the two CYCCNT reads. Exception entry
+; adds 12 (6 when tail-chained from SysTick_Handler) and the return to
+; thread mode 10, so a switch is 70 to 76 cycles, 4.4 to 4.8 us.
+PendSV_Handler
+        LDR     R3, =DWT_CYCCNT     ; 2
+        LDR     R12, [R3]           ; 2  switch start time
+        CPSID   I                   ; 1
+        MRS     R0, PSP             ; 1
+        STMDB   R0!, {R4-R11}       ; 9
+        LDR     R1, =RunPt          ; 2
+        LDR     R2, [R1]            ; 2
+        STR     R0, [R2]            ; 2  RunPt->sp = PSP
+        LDR     R2, =NextPt         ; 2
+        LDR     R2, [R2]            ; 2
+        STR     R2, [R1]            ; 2  RunPt = NextPt
+        LDR     R0, [R2]            ; 2
+        LDMIA   R0!, {R4-R11}       ; 9
+        MSR     PSP, R0             ; 1
+        LDR     R0, [R3]            ; 2
+        SUB     R0, R0, R12         ; 1  cycles for this switch
+        LDR     R1, =OS_SwitchCycles ; 2
+        LDR     R2, [R1]            ; 2
+        CMP     R0, R2              ; 1
+        IT      HI                  ; 1
+        STRHI   R0, [R1]            ; 2
+        CPSIE   I                   ; 1
+        BX      LR                  ; 3  EXC_RETURN: back to thread mode on PSP
+
+        ALIGN
+        END